@@ -0,0 +1,79 @@
+#!/bin/sh
+#
+# A profile-guided Release build of the headless frizBench on Linux, with GCC.
+#
+# This
+#   1. builds the plain Release (LTO) configuration and records the `frames`
+#      benchmark as the baseline,
+#   2. rebuilds it instrumented and runs the training workload (the scripted
+#      `createDemo ()` runs in the `frames` and `spawn` benchmarks),
+#   3. rebuilds it using that profile and records the `frames` benchmark again,
+# then prints the per-frame update and paint times before and after.
+#
+# Only frizBench is built: it shares the demo's sources but needs no display, so
+# the training and measuring runs work on a build machine or over ssh.
+#
+# usage: Scripts/linux-pgo.sh [output dir]    (default: Builds/pgo)
+#
+# The Makefiles are regenerated with Projucer first; set PROJUCER if it isn't
+# on the PATH. JUCE's Makefiles append CXXFLAGS/LDFLAGS from the command line,
+# which is how the profile flags get in without extra build configurations.
+# Those flags are GCC's, so the compiler (CXX, default g++) has to be GCC.
+
+set -eu
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+out=${1:-"$root/Builds/pgo"}
+projucer=${PROJUCER:-Projucer}
+jobs=$(nproc)
+training=frames,spawn
+
+cxx=${CXX:-g++}
+if ! "$cxx" -v 2>&1 | grep -q "^gcc version"; then
+    echo "linux-pgo.sh: $cxx isn't GCC; the profile flags need it (set CXX)" >&2
+    exit 1
+fi
+
+mkdir -p "$out"
+out=$(cd "$out" && pwd)
+
+# release <project dir> <CXXFLAGS> <LDFLAGS>
+release ()
+{
+    make -C "$1/Builds/LinuxMakefile" CONFIG=Release clean
+    make -C "$1/Builds/LinuxMakefile" CONFIG=Release -j"$jobs" \
+        CXX="$cxx" CXXFLAGS="$2" LDFLAGS="$3"
+}
+
+project="$root/Bench/frizBench"
+dir=$(dirname "$project")
+name=$(basename "$project")
+exe="$dir/Builds/LinuxMakefile/build/$name"
+profile="$out/$name-profile"
+
+"$projucer" --resave "$project.jucer"
+
+release "$dir" "" ""
+"$exe" --benchmark=frames --benchmark-out="$out/$name-before.json"
+
+rm -rf "$profile"
+generate="-fprofile-generate -fprofile-update=atomic -fprofile-dir=$profile"
+release "$dir" "$generate" "-fprofile-generate"
+"$exe" --benchmark=$training --benchmark-out="$out/$name-training.json"
+
+use="-fprofile-use -fprofile-correction -Wno-missing-profile -fprofile-dir=$profile"
+release "$dir" "$use" ""
+"$exe" --benchmark=frames --benchmark-out="$out/$name-after.json"
+
+python3 - "$out" "$name" <<'REPORT'
+import json, sys
+out, name = sys.argv[1:3]
+print ("%-10s %6s %14s %14s %14s %14s" % ("target", "boxes", "update before",
+                                          "update after", "paint before", "paint after"))
+before = json.load (open ("%s/%s-before.json" % (out, name)))["frames"]
+after = json.load (open ("%s/%s-after.json" % (out, name)))["frames"]
+for b, a in zip (before, after):
+    print ("%-10s %6d %11.3f ms %11.3f ms %11.3f ms %11.3f ms"
+           % (name, b["boxes"], b["updateMsPerFrame"], a["updateMsPerFrame"],
+              b["paintMsPerFrame"], a["paintMsPerFrame"]))
+REPORT
@@ -21,6 +21,9 @@
 */
 
 #include "MainComponent.h"
+#include "benchmark.h"
+#include "frameExporter.h"
+#include "stageScaling.h"
 
 //==============================================================================
 class animatorApplication : public juce::JUCEApplication
@@ -37,11 +40,70 @@ public:
     bool moreThanOneInstanceAllowed () override { return true; }
 
     //==============================================================================
-    void initialise (const juce::String& /*commandLine*/) override
+    void initialise (const juce::String& commandLine) override
     {
         // This method is where you should put your application's initialisation code..
+        if (Benchmark::isRequested (commandLine))
+        {
+            // headless run: measure, report, and leave without opening a window.
+            Benchmark benchmark (commandLine);
+            setApplicationReturnValue (benchmark.run ());
+            quit ();
+            return;
+        }
+
+        if (FrameExporter::isRequested (commandLine))
+        {
+            // headless offline render of a spawn script.
+            FrameExporter exporter (commandLine);
+            setApplicationReturnValue (exporter.run ());
+            quit ();
+            return;
+        }
+
+        // `--heatmap-out=<path>` saves the breadcrumb heatmap when we quit.
+        juce::File spawnLog;
+        juce::File flightLog;
+        for (const auto& arg : juce::StringArray::fromTokens (commandLine, true))
+        {
+            if (arg.startsWith (kHeatmapArg))
+                fHeatmapFile = juce::File::getCurrentWorkingDirectory ().getChildFile (
+                    arg.fromFirstOccurrenceOf (kHeatmapArg, false, false).unquoted ());
+            else if (arg.startsWith (kRecordArg))
+                spawnLog = juce::File::getCurrentWorkingDirectory ().getChildFile (
+                    arg.fromFirstOccurrenceOf (kRecordArg, false, false).unquoted ());
+            else if (arg.startsWith (kFlightArg))
+                flightLog = juce::File::getCurrentWorkingDirectory ().getChildFile (
+                    arg.fromFirstOccurrenceOf (kFlightArg, false, false).unquoted ());
+        }
+
+        if (StageScaling::isRequested (commandLine))
+        {
+            // this benchmark needs a window and a running message loop; it
+            // quits by itself when it's done.
+            mainWindow.reset (
+                new MainWindow (getApplicationName (), new StageScaling (commandLine)));
+            return;
+        }
+
+        mainWindow.reset (new MainWindow (getApplicationName (), new MainComponent ()));
+
+        // `--record-spawns=<path>` logs spawns for FrameExporter to play back.
+        if (spawnLog != juce::File ())
+        {
+            if (auto* content = dynamic_cast<MainComponent*> (
+                    mainWindow->getContentComponent ()))
+                content->recordSpawns (spawnLog);
+        }
 
-        mainWindow.reset (new MainWindow (getApplicationName ()));
+        // `--flight-recorder=<path>` keeps soak-test telemetry that survives a
+        // crash; decode it with Tools/flightDecode.
+        if (flightLog != juce::File ())
+        {
+            if (auto* content = dynamic_cast<MainComponent*> (
+                    mainWindow->getContentComponent ()))
+                content->startFlightRecorder (flightLog);
+        }
 #ifdef qRunUnitTests
         juce::UnitTestRunner testRunner;
         testRunner.runAllTests ();
@@ -51,6 +113,12 @@ public:
     void shutdown () override
     {
         // Add your application's shutdown code here..
+        if (mainWindow != nullptr && fHeatmapFile != juce::File ())
+        {
+            if (auto* content = dynamic_cast<MainComponent*> (
+                    mainWindow->getContentComponent ()))
+                content->exportHeatmap (fHeatmapFile);
+        }
 
         mainWindow = nullptr; // (deletes our window)
     }
@@ -79,7 +147,7 @@ public:
     class MainWindow : public juce::DocumentWindow
     {
     public:
-        MainWindow (juce::String name)
+        MainWindow (juce::String name, juce::Component* content)
         : juce::DocumentWindow (
               name,
               juce::Desktop::getInstance ().getDefaultLookAndFeel ().findColour (
@@ -87,7 +155,7 @@ public:
               juce::DocumentWindow::allButtons)
         {
             setUsingNativeTitleBar (true);
-            setContentOwned (new MainComponent (), true);
+            setContentOwned (content, true);
 
 #if JUCE_IOS || JUCE_ANDROID
             setFullScreen (true);
@@ -119,7 +187,12 @@ public:
     };
 
 private:
+    const juce::String kHeatmapArg { "--heatmap-out=" };
+    const juce::String kRecordArg { "--record-spawns=" };
+    const juce::String kFlightArg { "--flight-recorder=" };
+
     std::unique_ptr<MainWindow> mainWindow;
+    juce::File fHeatmapFile;
 };
 
 //==============================================================================
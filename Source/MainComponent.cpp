@@ -21,6 +21,7 @@
 */
 
 #include "MainComponent.h"
+#include "frameExporter.h"
 
 namespace
 {
@@ -30,40 +31,102 @@ const int kClosedPanelWidth { 30 };
 
 //==============================================================================
 MainComponent::MainComponent ()
-: fParams (ID::kParameters)
+: fParams (createDefaultParams ())
 , fStage (fParams)
 , fPanelState (PanelState::kOpen)
 {
-    fParams.setProperty (ID::kBreadcrumbs, true, nullptr);
-    fParams.setProperty (ID::kDuration, 500, nullptr);
-    fParams.setProperty (ID::kEaseOutToleranceX, 0.6f, nullptr);
-    fParams.setProperty (ID::kEaseOutToleranceY, 0.6f, nullptr);
-    fParams.setProperty (ID::kEaseOutSlewX, 1.2f, nullptr);
-    fParams.setProperty (ID::kEaseOutSlewY, 1.2f, nullptr);
-    fParams.setProperty (ID::kEaseInToleranceX, 0.01f, nullptr);
-    fParams.setProperty (ID::kEaseInToleranceY, 0.01f, nullptr);
-    fParams.setProperty (ID::kEaseInSlewX, 0.5f, nullptr);
-    fParams.setProperty (ID::kEaseInSlewY, 0.5f, nullptr);
-
-    fParams.setProperty (ID::kSpringDampingX, 0.5f, nullptr);
-    fParams.setProperty (ID::kSpringDampingY, 0.5f, nullptr);
-    fParams.setProperty (ID::kSpringToleranceX, 0.5f, nullptr);
-    fParams.setProperty (ID::kSpringToleranceY, 0.5f, nullptr);
-
-    fParams.setProperty (ID::kFadeDelay, 1000, nullptr);
-    fParams.setProperty (ID::kFadeDuration, 1000, nullptr);
-
     addAndMakeVisible (fStage);
 
     fControls = std::make_unique<ControlPanel> (fParams);
 
     addAndMakeVisible (fControls.get ());
     fControls->addChangeListener (this);
+
+    fInspector = std::make_unique<InspectorPanel> (fStage);
+    addChildComponent (fInspector.get ());
+    fParams.addListener (this);
+
     setSize (1000, 740);
 }
 
+bool MainComponent::exportHeatmap (const juce::File& file)
+{
+    return fStage.exportHeatmap (file);
+}
+
+bool MainComponent::startFlightRecorder (const juce::File& file)
+{
+    fRecorder = std::make_unique<FlightRecorder> (file);
+    if (!fRecorder->isOpen ())
+    {
+        fRecorder.reset ();
+        return false;
+    }
+    fStage.setFlightRecorder (fRecorder.get ());
+    return true;
+}
+
+bool MainComponent::recordSpawns (const juce::File& file)
+{
+    file.deleteFile ();
+    fSpawnLog = std::make_unique<juce::FileOutputStream> (file);
+    if (!fSpawnLog->openedOk ())
+    {
+        fSpawnLog.reset ();
+        return false;
+    }
+
+    fStage.onSpawn = [this] (juce::Point<int> point, DemoComponent::EffectType type)
+    {
+        // times are relative to the first spawn.
+        const auto now { juce::Time::getMillisecondCounterHiRes () };
+        if (fSpawnLogStart < 0.0)
+            fSpawnLogStart = now;
+
+        const FrameExporter::Spawn spawn { now - fSpawnLogStart, point, type };
+        *fSpawnLog << FrameExporter::formatSpawn (spawn) << "\n";
+        fSpawnLog->flush ();
+    };
+    return true;
+}
+
+juce::ValueTree MainComponent::createDefaultParams ()
+{
+    juce::ValueTree params (ID::kParameters);
+    params.setProperty (ID::kBreadcrumbs, true, nullptr);
+    params.setProperty (ID::kHeatmap, false, nullptr);
+    params.setProperty (ID::kCacheBoxLayers, false, nullptr);
+    params.setProperty (ID::kCrowd, false, nullptr);
+    params.setProperty (ID::kCrowdParallel, false, nullptr);
+    params.setProperty (ID::kInspector, false, nullptr);
+    params.setProperty (ID::kSprayMode, false, nullptr);
+    params.setProperty (ID::kSprayCount, 10, nullptr);
+    params.setProperty (ID::kInOutDriver, 0, nullptr);
+    params.setProperty (ID::kDuration, 500, nullptr);
+    params.setProperty (ID::kEaseOutToleranceX, 0.6f, nullptr);
+    params.setProperty (ID::kEaseOutToleranceY, 0.6f, nullptr);
+    params.setProperty (ID::kEaseOutSlewX, 1.2f, nullptr);
+    params.setProperty (ID::kEaseOutSlewY, 1.2f, nullptr);
+    params.setProperty (ID::kEaseInToleranceX, 0.01f, nullptr);
+    params.setProperty (ID::kEaseInToleranceY, 0.01f, nullptr);
+    params.setProperty (ID::kEaseInSlewX, 0.5f, nullptr);
+    params.setProperty (ID::kEaseInSlewY, 0.5f, nullptr);
+
+    params.setProperty (ID::kSpringDampingX, 0.5f, nullptr);
+    params.setProperty (ID::kSpringDampingY, 0.5f, nullptr);
+    params.setProperty (ID::kSpringToleranceX, 0.5f, nullptr);
+    params.setProperty (ID::kSpringToleranceY, 0.5f, nullptr);
+
+    params.setProperty (ID::kFadeDelay, 1000, nullptr);
+    params.setProperty (ID::kFadeDuration, 1000, nullptr);
+
+    return params;
+}
+
 MainComponent::~MainComponent ()
 {
+    fStage.setFlightRecorder (nullptr);
+    fParams.removeListener (this);
     fControls->removeChangeListener (this);
     fControls = nullptr;
 }
@@ -80,6 +143,8 @@ void MainComponent::resized ()
 {
     const auto bounds = getLocalBounds ();
     fStage.setBounds (bounds);
+    // (just under the stage's frame rate display.)
+    fInspector->setTopLeftPosition (5, 28);
 
     if (fPanelState != PanelState::kClosing || fPanelState != kOpening)
     {
@@ -93,6 +158,24 @@ void MainComponent::resized ()
     }
 }
 
+void MainComponent::childBoundsChanged (juce::Component* child)
+{
+    // the control panel is opaque, so the stage can skip updating any boxes
+    // that are completely behind it.
+    if (fControls != nullptr && (child == fControls.get () || child == &fStage))
+    {
+        fStage.setOccluder (
+            fControls->getBounds ().translated (-fStage.getX (), -fStage.getY ()));
+    }
+}
+
+void MainComponent::valueTreePropertyChanged (juce::ValueTree& /*tree*/,
+                                              const juce::Identifier& param)
+{
+    if (param == ID::kInspector)
+        fInspector->setVisible (fParams.getProperty (ID::kInspector, false));
+}
+
 void MainComponent::changeListenerCallback (juce::ChangeBroadcaster* src)
 {
     if (src == fControls.get ())
@@ -136,9 +219,16 @@ void MainComponent::openPanel ()
         [this] (int /*id*/, const friz::Animation<1>::ValueList& val)
         { fControls->setTopLeftPosition (static_cast<int> (val[0]), 0); });
 
-    sequence->onCompletion ([this] (int /*id*/, bool /*wasCanceled*/)
-                            { fPanelState = PanelState::kOpen; });
+    sequence->onCompletion (
+        [this] (int /*id*/, bool /*wasCanceled*/)
+        {
+            AnimatedLayer::end (*fControls);
+            fPanelState = PanelState::kOpen;
+        });
 
+    // the panel only moves while it's opening, so blit a snapshot of it instead
+    // of repainting it and all of its controls every frame.
+    AnimatedLayer::begin (*fControls);
     fPanelState = PanelState::kOpening;
     fPanelAnimator.addAnimation (std::move (sequence));
 }
@@ -162,9 +252,14 @@ void MainComponent::closePanel ()
         [this] (int /*id*/, const auto& val)
         { fControls->setTopLeftPosition (static_cast<int> (val[0]), 0); });
 
-    animation->onCompletion ([this] (int /*id*/, bool /*wasCanceled*/)
-                             { fPanelState = PanelState::kClosed; });
+    animation->onCompletion (
+        [this] (int /*id*/, bool /*wasCanceled*/)
+        {
+            AnimatedLayer::end (*fControls);
+            fPanelState = PanelState::kClosed;
+        });
 
+    AnimatedLayer::begin (*fControls);
     fPanelState = PanelState::kClosing;
     fPanelAnimator.addAnimation (std::move (animation));
 }
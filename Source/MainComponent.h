@@ -22,11 +22,14 @@
 
 #include "animatorApp.h"
 
+#include "animatedLayer.h"
 #include "controlPanel.h"
 #include "demoComponent.h"
+#include "inspectorPanel.h"
 
 class MainComponent : public juce::Component,
-                      public juce::ChangeListener
+                      public juce::ChangeListener,
+                      public juce::ValueTree::Listener
 {
 public:
     MainComponent ();
@@ -34,9 +37,35 @@ public:
 
     void paint (juce::Graphics&) override;
     void resized () override;
+    void childBoundsChanged (juce::Component* child) override;
 
     void changeListenerCallback (juce::ChangeBroadcaster* src) override;
 
+    void valueTreePropertyChanged (juce::ValueTree& tree,
+                                   const juce::Identifier& param) override;
+
+    /**
+     * @return a parameter tree filled with the demo's default settings.
+     */
+    static juce::ValueTree createDefaultParams ();
+
+    /**
+     * Write the stage's breadcrumb density heatmap to a PNG file.
+     */
+    bool exportHeatmap (const juce::File& file);
+
+    /**
+     * Log every box spawned from now on to `file`, in the format that the
+     * offline FrameExporter plays back.
+     */
+    bool recordSpawns (const juce::File& file);
+
+    /**
+     * Keep a flight recording of the stage in `file` (see `FlightRecorder`).
+     * @return false if the file couldn't be set up.
+     */
+    bool startFlightRecorder (const juce::File& file);
+
 private:
     void openPanel ();
 
@@ -47,6 +76,11 @@ private:
 
     DemoComponent fStage;
     std::unique_ptr<ControlPanel> fControls;
+    std::unique_ptr<InspectorPanel> fInspector;
+
+    std::unique_ptr<juce::FileOutputStream> fSpawnLog;
+    double fSpawnLogStart { -1.0 };
+    std::unique_ptr<FlightRecorder> fRecorder;
 
     friz::Animator fPanelAnimator;
 
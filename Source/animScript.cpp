@@ -0,0 +1,133 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "animScript.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace
+{
+// number of blocks to add to the pool each time it runs dry.
+const std::size_t kBlocksPerChunk { 64 };
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct PoolState
+{
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+    FreeBlock* freeList { nullptr };
+    std::size_t capacity { 0 };
+};
+
+PoolState& getPool ()
+{
+    static PoolState pool;
+    return pool;
+}
+} // namespace
+
+void* ScriptPool::allocate (std::size_t size)
+{
+    if (size > kBlockSize)
+        return ::operator new (size);
+
+    auto& pool { getPool () };
+    if (pool.freeList == nullptr)
+    {
+        auto chunk { std::make_unique<std::byte[]> (kBlockSize * kBlocksPerChunk) };
+        for (std::size_t i { 0 }; i < kBlocksPerChunk; ++i)
+        {
+            auto* block { reinterpret_cast<FreeBlock*> (chunk.get () + i * kBlockSize) };
+            block->next   = pool.freeList;
+            pool.freeList = block;
+        }
+        pool.chunks.push_back (std::move (chunk));
+        pool.capacity += kBlocksPerChunk;
+    }
+
+    auto* block { pool.freeList };
+    pool.freeList = block->next;
+    return block;
+}
+
+void ScriptPool::release (void* block, std::size_t size)
+{
+    if (size > kBlockSize)
+    {
+        ::operator delete (block);
+        return;
+    }
+
+    auto& pool { getPool () };
+    auto* freed { static_cast<FreeBlock*> (block) };
+    freed->next   = pool.freeList;
+    pool.freeList = freed;
+}
+
+std::size_t ScriptPool::getCapacity ()
+{
+    return getPool ().capacity;
+}
+
+AnimScript::AnimScript (AnimScript&& other) noexcept
+: fHandle { std::exchange (other.fHandle, {}) }
+{
+}
+
+AnimScript& AnimScript::operator= (AnimScript&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (fHandle)
+            fHandle.destroy ();
+        fHandle = std::exchange (other.fHandle, {});
+    }
+    return *this;
+}
+
+AnimScript::~AnimScript ()
+{
+    if (fHandle)
+        fHandle.destroy ();
+}
+
+bool AnimScript::tick (float ms)
+{
+    if (isDone ())
+        return true;
+
+    auto& promise { fHandle.promise () };
+    if (promise.advance != nullptr && !promise.advance (promise.stage, ms))
+        return false;
+
+    // the stage is finished; run the script up to its next co_await (which
+    // installs the next stage) or to its end.
+    promise.stage   = nullptr;
+    promise.advance = nullptr;
+    fHandle.resume ();
+    return fHandle.done ();
+}
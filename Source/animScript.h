@@ -0,0 +1,228 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <vector>
+
+#include "keyedRunner.h"
+#include "stepCurves.h"
+
+/**
+ * @class ScriptPool
+ * @brief Fixed-size block allocator for animation script coroutine frames.
+ *
+ * Every script's frame is carved out of a shared free list of `kBlockSize`
+ * byte blocks, so starting and finishing a script never touches the general
+ * purpose heap once the pool has warmed up. Frames too large for a block fall
+ * back to `operator new`. Only to be used from the message thread.
+ */
+class ScriptPool
+{
+public:
+    static constexpr std::size_t kBlockSize { 512 };
+
+    static void* allocate (std::size_t size);
+    static void release (void* block, std::size_t size);
+
+    /**
+     * @return number of blocks the pool has allocated so far.
+     */
+    static std::size_t getCapacity ();
+};
+
+/**
+ * @class AnimScript
+ * @brief A coroutine that describes a multi-stage animation as straight-line code.
+ *
+ * ```
+ * AnimScript wobble (juce::Component& c)
+ * {
+ *     const auto move = [&c] (float x) { c.setTopLeftPosition ((int) x, 0); };
+ *     co_await script::tween (step::EaseIn { 0.f, 100.f, 0.1f, 0.2f }, move);
+ *     co_await script::delay (250.f);
+ *     co_await script::tween (step::Spring { 100.f, 0.f, 0.5f, 1.f, 0.5f }, move);
+ * }
+ * ```
+ *
+ * The script runs until its first `co_await` as soon as it's called. After
+ * that, each call to `tick ()` advances the stage it's waiting on and resumes
+ * the script only when that stage is finished. All of a script's state (its
+ * locals and the curve it's currently waiting on) lives in its coroutine frame.
+ */
+class AnimScript
+{
+public:
+    struct promise_type
+    {
+        AnimScript get_return_object ()
+        {
+            using Handle = std::coroutine_handle<promise_type>;
+            return AnimScript { Handle::from_promise (*this) };
+        }
+
+        std::suspend_never initial_suspend () noexcept { return {}; }
+        std::suspend_always final_suspend () noexcept { return {}; }
+        void return_void () noexcept {}
+        void unhandled_exception () { std::terminate (); }
+
+        static void* operator new (std::size_t size)
+        {
+            return ScriptPool::allocate (size);
+        }
+
+        static void operator delete (void* frame, std::size_t size)
+        {
+            ScriptPool::release (frame, size);
+        }
+
+        /// the awaitable the script is currently suspended on, and how to advance it.
+        void* stage { nullptr };
+        bool (*advance) (void* stage, float ms) { nullptr };
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    AnimScript () = default;
+    AnimScript (AnimScript&& other) noexcept;
+    AnimScript& operator= (AnimScript&& other) noexcept;
+    ~AnimScript ();
+
+    AnimScript (const AnimScript&)            = delete;
+    AnimScript& operator= (const AnimScript&) = delete;
+
+    /**
+     * Advance the script by `ms` milliseconds.
+     * @return true if the script has finished.
+     */
+    bool tick (float ms);
+
+    bool isDone () const { return !fHandle || fHandle.done (); }
+
+private:
+    explicit AnimScript (Handle handle)
+    : fHandle { handle }
+    {
+    }
+
+    Handle fHandle;
+};
+
+namespace script
+{
+/**
+ * Awaitable that steps a single curve until it finishes, passing its value to
+ * `fn` every frame.
+ */
+template <typename Curve, typename Fn> struct Tween
+{
+    bool await_ready () const noexcept { return false; }
+
+    void await_suspend (AnimScript::Handle handle) noexcept
+    {
+        handle.promise ().stage   = this;
+        handle.promise ().advance = &Tween::advance;
+    }
+
+    void await_resume () const noexcept {}
+
+    static bool advance (void* self, float ms)
+    {
+        auto& tween { *static_cast<Tween*> (self) };
+        const auto done { tween.curve.step (ms) };
+        tween.fn (tween.curve.value);
+        return done;
+    }
+
+    Curve curve;
+    Fn fn;
+};
+
+/**
+ * Awaitable that steps a pair of curves (usually x and y) together, finishing
+ * when both of them have.
+ */
+template <typename CurveX, typename CurveY, typename Fn> struct Tween2
+{
+    bool await_ready () const noexcept { return false; }
+
+    void await_suspend (AnimScript::Handle handle) noexcept
+    {
+        handle.promise ().stage   = this;
+        handle.promise ().advance = &Tween2::advance;
+    }
+
+    void await_resume () const noexcept {}
+
+    static bool advance (void* self, float ms)
+    {
+        auto& tween { *static_cast<Tween2*> (self) };
+        const auto xDone { tween.x.step (ms) };
+        const auto yDone { tween.y.step (ms) };
+        tween.fn (tween.x.value, tween.y.value);
+        return xDone && yDone;
+    }
+
+    CurveX x;
+    CurveY y;
+    Fn fn;
+};
+
+struct Ignore
+{
+    void operator() (float) const {}
+};
+
+template <typename Curve, typename Fn> Tween<Curve, Fn> tween (Curve curve, Fn fn)
+{
+    return { curve, std::move (fn) };
+}
+
+template <typename CurveX, typename CurveY, typename Fn>
+Tween2<CurveX, CurveY, Fn> tween (CurveX x, CurveY y, Fn fn)
+{
+    return { x, y, std::move (fn) };
+}
+
+inline Tween<step::Delay, Ignore> delay (float ms)
+{
+    return { step::Delay { ms }, Ignore {} };
+}
+} // namespace script
+
+/**
+ * How a `KeyedRunner` runs scripts: each step resumes the script as far as its
+ * current stage allows.
+ */
+struct ScriptSteps
+{
+    static void step (AnimScript& script, float ms) { script.tick (ms); }
+    static bool isDone (const AnimScript& script) { return script.isDone (); }
+};
+
+/**
+ * Owns a set of running scripts and ticks them all from a single FrameClock;
+ * scripts that never awaited anything are discarded when they're added.
+ */
+using ScriptRunner = KeyedRunner<AnimScript, ScriptSteps>;
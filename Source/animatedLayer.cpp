@@ -0,0 +1,62 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "animatedLayer.h"
+
+const juce::Identifier AnimatedLayer::kLayerCount { "animatedLayerCount" };
+
+void AnimatedLayer::begin (juce::Component& comp)
+{
+    auto& props { comp.getProperties () };
+    const int count = props.getWithDefault (kLayerCount, 0);
+    props.set (kLayerCount, count + 1);
+
+    if (0 == count)
+        comp.setBufferedToImage (true);
+}
+
+void AnimatedLayer::end (juce::Component& comp)
+{
+    auto& props { comp.getProperties () };
+    const int count = props.getWithDefault (kLayerCount, 0);
+    if (count <= 0)
+    {
+        // unbalanced call to end()
+        jassertfalse;
+        return;
+    }
+
+    if (1 == count)
+    {
+        props.remove (kLayerCount);
+        comp.setBufferedToImage (false);
+    }
+    else
+    {
+        props.set (kLayerCount, count - 1);
+    }
+}
+
+bool AnimatedLayer::isActive (const juce::Component& comp)
+{
+    return comp.getProperties ().contains (kLayerCount);
+}
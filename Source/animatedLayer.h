@@ -0,0 +1,62 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class AnimatedLayer
+ * @brief Treat a component as a cached compositing layer while it's animating.
+ *
+ * When a friz animation is only changing a component's position or opacity,
+ * there's no need to repaint the component (and all of its children) on every
+ * frame. Calling `begin()` snapshots the component into an image the next time
+ * it's painted; each frame after that just blits the image. `end()` goes back
+ * to painting the live component tree.
+ *
+ * Calls nest, so several animations can hold the same component as a layer;
+ * it's only released after the last one calls `end()`. Anything that repaints
+ * the component itself (not just moving it) invalidates the snapshot, so this
+ * isn't useful while e.g. a color is being animated.
+ */
+class AnimatedLayer
+{
+public:
+    /**
+     * Start caching `comp` as a layer.
+     */
+    static void begin (juce::Component& comp);
+
+    /**
+     * Release one hold on `comp`; when no holds are left, go back to painting
+     * it normally.
+     */
+    static void end (juce::Component& comp);
+
+    /**
+     * @return true if `comp` is currently being cached as a layer.
+     */
+    static bool isActive (const juce::Component& comp);
+
+private:
+    static const juce::Identifier kLayerCount;
+};
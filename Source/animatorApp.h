@@ -32,6 +32,14 @@ namespace ID
 {
 const juce::Identifier kParameters { "params" };
 const juce::Identifier kBreadcrumbs { "breadcrumbs" };
+const juce::Identifier kHeatmap { "heatmap" }; // bool
+const juce::Identifier kCacheBoxLayers { "cacheBoxLayers" };
+const juce::Identifier kCrowd { "crowd" };                 // bool
+const juce::Identifier kCrowdParallel { "crowdParallel" }; // bool
+const juce::Identifier kInspector { "inspector" };         // bool
+const juce::Identifier kSprayMode { "sprayMode" };   // bool
+const juce::Identifier kSprayCount { "sprayCount" }; // int, boxes per drag event
+const juce::Identifier kInOutDriver { "inOutDriver" }; // int/enum
 const juce::Identifier kDuration { "dur" };
 const juce::Identifier kCurve { "curve" }; // int/enum
 
@@ -53,3 +61,8 @@ const juce::Identifier kSpringDampingY { "springDampingY" };
 const juce::Identifier kFadeDelay { "fadeDelay" };  // int
 const juce::Identifier kFadeDuration { "fadeDur" }; // int
 } // namespace ID
+
+/// the system random number generator is re-seeded with this before a headless
+/// run (rendering or benchmarking), so box sizes, colours and destinations are
+/// the same every time.
+const juce::int64 kRandomSeed { 0x667269 };
@@ -0,0 +1,54 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Entry point of the headless `frizBench` executable (`Bench/frizBench.jucer`),
+ * which builds the same sources as the app minus `Main.cpp`. It takes the
+ * app's benchmark options, so
+ *
+ *     frizBench --benchmark=frames --benchmark-out=frames.json
+ *
+ * is the same run as `frizDemo --benchmark=frames ...` without the application
+ * shell around it. With no `--benchmark` option, every benchmark is run.
+ */
+
+#include "benchmark.h"
+
+int main (int argc, char* argv[])
+{
+    // the stage and its animators need a message manager, even with no window.
+    juce::ScopedJuceInitialiser_GUI init;
+
+    juce::StringArray args;
+    for (int i { 1 }; i < argc; ++i)
+    {
+        // (quoted the way JUCE builds an app's command line.)
+        const juce::String arg { juce::CharPointer_UTF8 (argv[i]) };
+        args.add (arg.containsChar (' ') ? arg.quoted () : arg);
+    }
+    auto commandLine { args.joinIntoString (" ") };
+    if (!Benchmark::isRequested (commandLine))
+        commandLine = "--benchmark " + commandLine;
+
+    Benchmark benchmark (commandLine);
+    return benchmark.run ();
+}
@@ -0,0 +1,1000 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "benchmark.h"
+#include "MainComponent.h"
+#include "animScript.h"
+#include "boxStore.h"
+#include "breadcrumbs.h"
+#include "crowd.h"
+#include "mpscQueue.h"
+#include "perfCounters.h"
+#include "pipeline.h"
+#include "sharedTimeline.h"
+#include "timerWheel.h"
+#include "trajectoryCache.h"
+
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+const juce::String kBenchmarkArg { "--benchmark" };
+const juce::String kOutputArg { "--benchmark-out=" };
+
+const int kFrames { 60 };
+const int kLookups { 1000 };
+
+// the `frames` workload: 4 seconds at 60 fps, spawning in bursts through the
+// first half of it.
+const int kWorkloadFrames { 240 };
+const int kBurstInterval { 6 };
+const int kEffectCount { 6 };
+
+/**
+ * Stands in for the per-box component layout that the demo used to update
+ * directly.
+ */
+class ComponentBox : public juce::Component
+{
+public:
+    explicit ComponentBox (int id)
+    : boxId { id }
+    {
+    }
+
+    int boxId;
+    float saturation { 0.9f };
+};
+
+double elapsedNs (juce::int64 startTicks)
+{
+    const auto ticks { juce::Time::getHighResolutionTicks () - startTicks };
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e9;
+}
+
+/**
+ * The scripted `createDemo ()` workload of the `frames` and `counters`
+ * benchmarks: `boxCount` boxes cycling through every effect type, spawned in
+ * bursts over the first half of the run.
+ */
+class FrameWorkload
+{
+public:
+    FrameWorkload (DemoComponent& stage, int boxCount)
+    : fStage { stage }
+    , fBoxCount { boxCount }
+    , fPerBurst { std::max (1, boxCount / (kWorkloadFrames / 2 / kBurstInterval)) }
+    {
+        // the same work on every run, however long it takes.
+        fStage.getScheduler ().setBudget (0.f);
+    }
+
+    /**
+     * Spawn whatever is due at the start of `frame`.
+     */
+    void spawn (int frame)
+    {
+        if (frame % kBurstInterval != 0)
+            return;
+        using Effect = DemoComponent::EffectType;
+        for (int i { 0 }; i < fPerBurst && fSpawned < fBoxCount; ++i, ++fSpawned)
+            fStage.createDemo ({ fRandom.nextInt (900), fRandom.nextInt (640) },
+                               static_cast<Effect> (fSpawned % kEffectCount));
+    }
+
+    int getSpawned () const { return fSpawned; }
+
+private:
+    DemoComponent& fStage;
+    const int fBoxCount;
+    const int fPerBurst;
+    int fSpawned { 0 };
+    juce::Random fRandom { 42 };
+};
+
+/**
+ * The same motion as the demo's in/out effect, writing its position to `out`.
+ */
+AnimScript inOutScript (float* out)
+{
+    const auto move { [out] (float x, float y)
+                      {
+                          out[0] = x;
+                          out[1] = y;
+                      } };
+    co_await script::tween (step::EaseIn { 0.f, 100.f, 0.1f, 0.1f },
+                            step::EaseIn { 0.f, 50.f, 0.1f, 0.1f }, move);
+    co_await script::tween (step::EaseOut { 100.f, 200.f, 0.6f, 1.2f },
+                            step::EaseOut { 50.f, 100.f, 0.6f, 1.2f }, move);
+}
+
+struct PointSink
+{
+    void operator() (float x, float y) const
+    {
+        out[0] = x;
+        out[1] = y;
+    }
+    void finished () const {}
+
+    float* out;
+};
+
+auto inOutPipeline (float* out)
+{
+    auto moveIn { pipeline::move (step::EaseIn { 0.f, 100.f, 0.1f, 0.1f },
+                                  step::EaseIn { 0.f, 50.f, 0.1f, 0.1f }) };
+    auto moveOut { pipeline::move (step::EaseOut { 100.f, 200.f, 0.6f, 1.2f },
+                                   step::EaseOut { 50.f, 100.f, 0.6f, 1.2f }) };
+    return pipeline::make (pipeline::sequence (moveIn, moveOut), PointSink { out });
+}
+
+std::unique_ptr<friz::Chain> inOutChain (int id, float* out)
+{
+    using fx2 = friz::Animation<2>::SourceList;
+    auto sequence { std::make_unique<friz::Sequence<2>> (id) };
+    sequence->addAnimation (std::make_unique<friz::Animation<2>> (
+        fx2 { std::make_unique<friz::EaseIn> (0.f, 100.f, 0.1f, 0.1f),
+              std::make_unique<friz::EaseIn> (0.f, 50.f, 0.1f, 0.1f) }));
+    sequence->addAnimation (std::make_unique<friz::Animation<2>> (
+        fx2 { std::make_unique<friz::EaseOut> (100.f, 200.f, 0.6f, 1.2f),
+              std::make_unique<friz::EaseOut> (50.f, 100.f, 0.6f, 1.2f) }));
+    sequence->onUpdate (
+        [out] (int, const friz::Animation<2>::ValueList& val)
+        {
+            out[0] = val[0];
+            out[1] = val[1];
+        });
+
+    auto chain { std::make_unique<friz::Chain> (id) };
+    chain->addAnimation (std::move (sequence));
+    return chain;
+}
+} // namespace
+
+Benchmark::Benchmark (const juce::String& commandLine)
+{
+    for (const auto& arg : juce::StringArray::fromTokens (commandLine, true))
+    {
+        if (arg.startsWith (kOutputArg))
+            fOutput = juce::File::getCurrentWorkingDirectory ().getChildFile (
+                arg.fromFirstOccurrenceOf (kOutputArg, false, false).unquoted ());
+        else if (arg.startsWith (kBenchmarkArg + "="))
+            fSelected.addTokens (arg.fromFirstOccurrenceOf ("=", false, false), ",", "");
+    }
+}
+
+bool Benchmark::isRequested (const juce::String& commandLine)
+{
+    return commandLine.contains (kBenchmarkArg);
+}
+
+bool Benchmark::wants (juce::StringRef name) const
+{
+    return fSelected.isEmpty () || fSelected.contains (name);
+}
+
+int Benchmark::run ()
+{
+    juce::DynamicObject::Ptr results { new juce::DynamicObject };
+
+    if (wants ("boxUpdate"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 1000, 10000, 100000 })
+            runs.add (runBoxUpdate (count));
+        results->setProperty ("boxUpdate", runs);
+    }
+
+    if (wants ("spawn"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 100, 1000, 5000 })
+            runs.add (runSpawn (count));
+        results->setProperty ("spawn", runs);
+    }
+
+    if (wants ("frames"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 100, 1000 })
+            runs.add (runFrames (count));
+        results->setProperty ("frames", runs);
+    }
+
+    if (wants ("counters"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 100, 1000 })
+            runs.add (runCounters (count));
+        results->setProperty ("counters", runs);
+    }
+
+    if (wants ("script"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 100, 1000, 10000 })
+            runs.add (runScript (count));
+        results->setProperty ("script", runs);
+    }
+
+    if (wants ("breadcrumbs"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 10, 100, 1000 })
+            runs.add (runBreadcrumbs (count));
+        results->setProperty ("breadcrumbs", runs);
+    }
+
+    if (wants ("trajectory"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 1000, 10000, 100000 })
+            runs.add (runTrajectory (count));
+        results->setProperty ("trajectory", runs);
+    }
+
+    if (wants ("crowd"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 100, 1000, 10000 })
+            runs.add (runCrowd (count));
+        results->setProperty ("crowd", runs);
+    }
+
+    if (wants ("timerWheel"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 1000, 10000, 100000 })
+            runs.add (runTimerWheel (count));
+        results->setProperty ("timerWheel", runs);
+    }
+
+    if (wants ("fanOut"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 1000, 10000, 100000 })
+            runs.add (runFanOut (count));
+        results->setProperty ("fanOut", runs);
+    }
+
+    if (wants ("spawnQueue"))
+    {
+        juce::Array<juce::var> runs;
+        for (auto count : { 10000, 100000 })
+            runs.add (runSpawnQueue (count));
+        results->setProperty ("spawnQueue", runs);
+    }
+
+    const auto json { juce::JSON::toString (juce::var (results.get ())) };
+    if (fOutput == juce::File ())
+        std::cout << json << std::endl;
+    else if (!fOutput.replaceWithText (json))
+        return 1;
+
+    return 0;
+}
+
+juce::var Benchmark::runBoxUpdate (int boxCount)
+{
+    juce::Random r { 42 };
+
+    std::vector<std::unique_ptr<ComponentBox>> boxes;
+    boxes.reserve (static_cast<size_t> (boxCount));
+    BoxStore store;
+    store.reserve (static_cast<size_t> (boxCount));
+
+    for (int i { 0 }; i < boxCount; ++i)
+    {
+        const juce::Rectangle<int> bounds { r.nextInt (1000), r.nextInt (740), 50, 50 };
+        boxes.push_back (std::make_unique<ComponentBox> (i));
+        boxes.back ()->setBounds (bounds);
+        store.add (i, boxes.back ().get (), bounds.toFloat (),
+                   ColourRamp::getBucket (r.nextFloat ()), 0.9f);
+    }
+
+    // hardware counters (where available) show the cache misses behind the times.
+    PerfCounters counters;
+
+    // one frame: every box gets a new position and saturation.
+    auto start { juce::Time::getHighResolutionTicks () };
+    counters.start ();
+    for (int frame { 0 }; frame < kFrames; ++frame)
+    {
+        const auto sat { 1.f - static_cast<float> (frame) / kFrames };
+        for (auto& box : boxes)
+        {
+            box->setTopLeftPosition (box->getX () + 1, box->getY ());
+            box->saturation = sat;
+        }
+    }
+    const auto componentCounts { counters.stop () };
+    const auto componentNs { elapsedNs (start) };
+
+    size_t flushed { 0 };
+    start = juce::Time::getHighResolutionTicks ();
+    counters.start ();
+    for (int frame { 0 }; frame < kFrames; ++frame)
+    {
+        const auto sat { 1.f - static_cast<float> (frame) / kFrames };
+        const auto count { store.size () };
+        for (size_t slot { 0 }; slot < count; ++slot)
+        {
+            store.setPosition (slot, store.getX (slot) + 1.f, store.getY (slot));
+            store.setSaturation (slot, sat);
+        }
+        // ...and the components end up where the store put them, as in the demo.
+        store.flush (
+            [&store, &flushed] (size_t slot, uint8_t flags)
+            {
+                auto* box { static_cast<ComponentBox*> (store.getView (slot)) };
+                if ((flags & BoxStore::kPosition) != 0)
+                {
+                    box->setTopLeftPosition (static_cast<int> (store.getX (slot)),
+                                             static_cast<int> (store.getY (slot)));
+                }
+                if ((flags & BoxStore::kColor) != 0)
+                    box->saturation = store.getSaturation (slot);
+                ++flushed;
+            });
+    }
+    const auto storeCounts { counters.stop () };
+    const auto storeNs { elapsedNs (start) };
+    jassert (flushed == static_cast<size_t> (boxCount * kFrames));
+
+    // looking up a box by id, as every animation callback does.
+    start = juce::Time::getHighResolutionTicks ();
+    size_t found { 0 };
+    for (int i { 0 }; i < kLookups; ++i)
+    {
+        const auto id { r.nextInt (boxCount) };
+        found += std::find_if (boxes.begin (), boxes.end (),
+                               [id] (const auto& box) { return box->boxId == id; }) !=
+                 boxes.end ();
+    }
+    const auto componentLookupNs { elapsedNs (start) };
+
+    start = juce::Time::getHighResolutionTicks ();
+    for (int i { 0 }; i < kLookups; ++i)
+        found += store.find (r.nextInt (boxCount)) != BoxStore::kNotFound;
+    const auto storeLookupNs { elapsedNs (start) };
+    jassert (found == 2 * kLookups);
+
+    const auto perBoxFrame { static_cast<double> (boxCount) * kFrames };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("boxes", boxCount);
+    result->setProperty ("frames", kFrames);
+    result->setProperty ("componentBytesPerBox",
+                         static_cast<int> (sizeof (ComponentBox)));
+    result->setProperty ("storeBytesPerBox", static_cast<int> (BoxStore::bytesPerBox ()));
+    result->setProperty ("componentUpdateNsPerBox", componentNs / perBoxFrame);
+    result->setProperty ("storeUpdateNsPerBox", storeNs / perBoxFrame);
+    result->setProperty ("componentLookupNs", componentLookupNs / kLookups);
+    result->setProperty ("storeLookupNs", storeLookupNs / kLookups);
+
+    result->setProperty ("countersAvailable", counters.isAvailable ());
+    if (!counters.isAvailable ())
+        result->setProperty ("countersError", counters.getError ());
+    const auto perBox { [perBoxFrame] (const PerfCounters::Counts& counts,
+                                       PerfCounters::Event event)
+                        {
+                            return static_cast<double> (counts.values[event]) /
+                                   perBoxFrame;
+                        } };
+    if (counters.isCounting (PerfCounters::kL1dMisses))
+    {
+        result->setProperty ("componentL1dMissesPerBox",
+                             perBox (componentCounts, PerfCounters::kL1dMisses));
+        result->setProperty ("storeL1dMissesPerBox",
+                             perBox (storeCounts, PerfCounters::kL1dMisses));
+    }
+    if (counters.isCounting (PerfCounters::kLlcMisses))
+    {
+        result->setProperty ("componentLlcMissesPerBox",
+                             perBox (componentCounts, PerfCounters::kLlcMisses));
+        result->setProperty ("storeLlcMissesPerBox",
+                             perBox (storeCounts, PerfCounters::kLlcMisses));
+    }
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runSpawn (int boxCount)
+{
+    using Effect = DemoComponent::EffectType;
+
+    auto params { MainComponent::createDefaultParams () };
+    params.setProperty (ID::kBreadcrumbs, false, nullptr);
+    DemoComponent stage (params);
+    stage.setSize (1000, 740);
+
+    juce::Random r { 42 };
+    auto start { juce::Time::getHighResolutionTicks () };
+    for (int i { 0 }; i < boxCount; ++i)
+        stage.createDemo ({ r.nextInt (900), r.nextInt (640) }, Effect::kEaseIn);
+    const auto singleNs { elapsedNs (start) };
+    stage.clear ();
+
+    start = juce::Time::getHighResolutionTicks ();
+    stage.createDemos (boxCount, { 0, 0, 900, 640 }, Effect::kEaseIn);
+    const auto batchNs { elapsedNs (start) };
+    stage.clear ();
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("boxes", boxCount);
+    result->setProperty ("singleNsPerBox", singleNs / boxCount);
+    result->setProperty ("batchNsPerBox", batchNs / boxCount);
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runFrames (int boxCount)
+{
+    juce::Random::getSystemRandom ().setSeed (kRandomSeed);
+    DemoComponent stage (MainComponent::createDefaultParams ());
+    stage.setSize (1000, 740);
+    juce::Image image { juce::Image::ARGB, stage.getWidth (), stage.getHeight (), true };
+
+    FrameWorkload workload { stage, boxCount };
+    double updateNs { 0.0 };
+    double paintNs { 0.0 };
+    for (int frame { 0 }; frame < kWorkloadFrames; ++frame)
+    {
+        workload.spawn (frame);
+
+        auto start { juce::Time::getHighResolutionTicks () };
+        stage.gotoTime ((frame + 1) * step::kFrameMs);
+        updateNs += elapsedNs (start);
+
+        start = juce::Time::getHighResolutionTicks ();
+        {
+            juce::Graphics g { image };
+            stage.paintEntireComponent (g, false);
+        }
+        paintNs += elapsedNs (start);
+    }
+    stage.clear ();
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("boxes", workload.getSpawned ());
+    result->setProperty ("frames", kWorkloadFrames);
+    result->setProperty ("updateMsPerFrame", updateNs / kWorkloadFrames / 1.0e6);
+    result->setProperty ("paintMsPerFrame", paintNs / kWorkloadFrames / 1.0e6);
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runCounters (int boxCount)
+{
+    enum Phase
+    {
+        kTick = 0,
+        kApply,
+        kBreadcrumbPaint,
+        kBoxPaint,
+        kNumPhases
+    };
+    const char* const phaseNames[] { "tick", "apply", "breadcrumbPaint", "boxPaint" };
+
+    juce::Random::getSystemRandom ().setSeed (kRandomSeed);
+    DemoComponent stage (MainComponent::createDefaultParams ());
+    stage.setSize (1000, 740);
+    juce::Image image { juce::Image::ARGB, stage.getWidth (), stage.getHeight (), true };
+    juce::Graphics g { image };
+
+    PerfCounters counters;
+    std::array<PerfCounters::Counts, kNumPhases> counts;
+    std::array<double, kNumPhases> phaseNs {};
+
+    // measures one phase of one frame.
+    const auto measure { [&] (Phase phase, auto&& fn)
+                         {
+                             const auto start { juce::Time::getHighResolutionTicks () };
+                             counters.start ();
+                             fn ();
+                             counts[phase] += counters.stop ();
+                             phaseNs[phase] += elapsedNs (start);
+                         } };
+
+    FrameWorkload workload { stage, boxCount };
+    // boxes alive in each frame, summed: the per-box costs are per box per frame.
+    double boxFrames { 0.0 };
+    for (int frame { 0 }; frame < kWorkloadFrames; ++frame)
+    {
+        workload.spawn (frame);
+        boxFrames += static_cast<double> (stage.getBoxCount ());
+        const auto now { (frame + 1) * step::kFrameMs };
+        measure (kTick, [&] { stage.tickAnimations (now); });
+        measure (kApply, [&] { stage.applyUpdates (); });
+        measure (kBreadcrumbPaint, [&] { stage.paintBreadcrumbs (g); });
+        measure (kBoxPaint, [&] { stage.paintBoxes (g); });
+    }
+    stage.clear ();
+
+    boxFrames = std::max (boxFrames, 1.0);
+    juce::DynamicObject::Ptr phases { new juce::DynamicObject };
+    for (int phase { 0 }; phase < kNumPhases; ++phase)
+    {
+        juce::DynamicObject::Ptr perFrame { new juce::DynamicObject };
+        juce::DynamicObject::Ptr perBox { new juce::DynamicObject };
+        perFrame->setProperty ("ms", phaseNs[phase] / kWorkloadFrames / 1.0e6);
+        perBox->setProperty ("ns", phaseNs[phase] / boxFrames);
+        for (int i { 0 }; i < PerfCounters::kNumEvents; ++i)
+        {
+            const auto event { static_cast<PerfCounters::Event> (i) };
+            if (!counters.isCounting (event))
+                continue;
+            const auto total { static_cast<double> (counts[phase].values[i]) };
+            const auto name { PerfCounters::getName (event) };
+            perFrame->setProperty (name, total / kWorkloadFrames);
+            perBox->setProperty (name, total / boxFrames);
+        }
+
+        juce::DynamicObject::Ptr entry { new juce::DynamicObject };
+        entry->setProperty ("perFrame", juce::var (perFrame.get ()));
+        entry->setProperty ("perBox", juce::var (perBox.get ()));
+        phases->setProperty (phaseNames[phase], juce::var (entry.get ()));
+    }
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("boxes", workload.getSpawned ());
+    result->setProperty ("frames", kWorkloadFrames);
+    result->setProperty ("boxFrames", boxFrames);
+    result->setProperty ("countersAvailable", counters.isAvailable ());
+    if (!counters.isAvailable ())
+        result->setProperty ("countersError", counters.getError ());
+    else
+    {
+        auto total { counts[0] };
+        for (int phase { 1 }; phase < kNumPhases; ++phase)
+            total += counts[phase];
+        // multiplexed counts are estimates; ones that never ran are meaningless.
+        result->setProperty ("countersScaled", total.scaled);
+        result->setProperty ("countersValid", total.valid);
+    }
+    result->setProperty ("phases", juce::var (phases.get ()));
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runScript (int count)
+{
+    const auto frameMs { 1000.f / 60.f };
+    std::vector<float> sink (static_cast<size_t> (count) * 2);
+
+    // friz: a Chain wrapping a Sequence of two Animation<2>s per movement.
+    friz::Animator animator;
+    auto start { juce::Time::getHighResolutionTicks () };
+    for (int i { 0 }; i < count; ++i)
+        animator.addAnimation (inOutChain (i + 1, &sink[static_cast<size_t> (i) * 2]));
+    const auto chainBuildNs { elapsedNs (start) };
+
+    start = juce::Time::getHighResolutionTicks ();
+    for (int frame { 1 }; frame <= kFrames; ++frame)
+        animator.gotoTime (frame * frameMs);
+    const auto chainTickNs { elapsedNs (start) };
+    animator.cancelAllAnimations (false);
+
+    // scripts: one pooled coroutine frame per movement.
+    friz::Animator clockAnimator;
+    ScriptRunner runner { clockAnimator, -1 };
+    start = juce::Time::getHighResolutionTicks ();
+    for (int i { 0 }; i < count; ++i)
+        runner.add (inOutScript (&sink[static_cast<size_t> (i) * 2]));
+    const auto scriptBuildNs { elapsedNs (start) };
+
+    start = juce::Time::getHighResolutionTicks ();
+    for (int frame { 0 }; frame < kFrames; ++frame)
+        runner.tick (frameMs);
+    const auto scriptTickNs { elapsedNs (start) };
+    runner.clear ();
+
+    // static pipelines: stored by value, one contiguous block for all of them.
+    using InOutPipeline = decltype (inOutPipeline (nullptr));
+    pipeline::Runner<InOutPipeline> pipelines { clockAnimator, -2 };
+    start = juce::Time::getHighResolutionTicks ();
+    pipelines.reserve (static_cast<size_t> (count));
+    for (int i { 0 }; i < count; ++i)
+        pipelines.add (inOutPipeline (&sink[static_cast<size_t> (i) * 2]));
+    const auto pipelineBuildNs { elapsedNs (start) };
+
+    start = juce::Time::getHighResolutionTicks ();
+    for (int frame { 0 }; frame < kFrames; ++frame)
+        pipelines.tick (frameMs);
+    const auto pipelineTickNs { elapsedNs (start) };
+    pipelines.clear ();
+
+    const auto perScriptFrame { static_cast<double> (count) * kFrames };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("count", count);
+    result->setProperty ("frames", kFrames);
+    result->setProperty ("scriptBytesPerBox", static_cast<int> (ScriptPool::kBlockSize));
+    result->setProperty ("pipelineBytesPerBox",
+                         static_cast<int> (sizeof (InOutPipeline)));
+    result->setProperty ("chainBuildNsPerBox", chainBuildNs / count);
+    result->setProperty ("scriptBuildNsPerBox", scriptBuildNs / count);
+    result->setProperty ("chainTickNsPerBox", chainTickNs / perScriptFrame);
+    result->setProperty ("scriptTickNsPerBox", scriptTickNs / perScriptFrame);
+    result->setProperty ("pipelineBuildNsPerBox", pipelineBuildNs / count);
+    result->setProperty ("pipelineTickNsPerBox", pipelineTickNs / perScriptFrame);
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runTrajectory (int count)
+{
+    juce::Random r { 42 };
+    std::vector<std::pair<float, float>> moves;
+    for (int i { 0 }; i < count; ++i)
+        moves.emplace_back (static_cast<float> (r.nextInt (1000)),
+                            static_cast<float> (r.nextInt (1000)));
+
+    std::vector<step::EaseIn> curves;
+    curves.reserve (moves.size ());
+    for (const auto& [start, end] : moves)
+        curves.push_back ({ start, end, 0.6f, 0.1f });
+
+    float sum { 0.f };
+    auto start { juce::Time::getHighResolutionTicks () };
+    for (int frame { 0 }; frame < kFrames; ++frame)
+    {
+        for (auto& curve : curves)
+        {
+            curve.step (step::kFrameMs);
+            sum += curve.value;
+        }
+    }
+    const auto simulateNs { elapsedNs (start) };
+
+    TrajectoryCache cache;
+    std::vector<TrajectoryCache::Replay> replays;
+    replays.reserve (moves.size ());
+    start = juce::Time::getHighResolutionTicks ();
+    for (const auto& [from, to] : moves)
+        replays.push_back (cache.easeIn (from, to, 0.6f, 0.1f));
+    const auto lookupNs { elapsedNs (start) };
+
+    start = juce::Time::getHighResolutionTicks ();
+    for (int frame { 0 }; frame < kFrames; ++frame)
+    {
+        for (auto& replay : replays)
+        {
+            replay.step (step::kFrameMs);
+            sum += replay.value;
+        }
+    }
+    const auto replayNs { elapsedNs (start) };
+    juce::ignoreUnused (sum);
+
+    const auto perCurveFrame { static_cast<double> (count) * kFrames };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("count", count);
+    result->setProperty ("frames", kFrames);
+    result->setProperty ("cachedPaths", static_cast<int> (cache.size ()));
+    result->setProperty ("cacheHitRate", static_cast<double> (cache.getHits ()) / count);
+    result->setProperty ("lookupNsPerBox", lookupNs / count);
+    result->setProperty ("simulateNsPerStep", simulateNs / perCurveFrame);
+    result->setProperty ("replayNsPerStep", replayNs / perCurveFrame);
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runBreadcrumbs (int count)
+{
+    const juce::Rectangle<int> stage { 0, 0, 1000, 740 };
+    const auto frameMs { 1000.f / 240.f };
+    juce::Random r { 42 };
+
+    juce::Path rectangles;
+    Breadcrumbs crumbs;
+    crumbs.setBounds (stage);
+
+    double rectangleAddNs { 0.0 };
+    double trailAddNs { 0.0 };
+    for (int i { 0 }; i < count; ++i)
+    {
+        const auto x0 { static_cast<float> (r.nextInt (stage.getWidth ())) };
+        const auto y0 { static_cast<float> (r.nextInt (stage.getHeight ())) };
+        const auto x1 { static_cast<float> (r.nextInt (stage.getWidth ())) };
+        const auto y1 { static_cast<float> (r.nextInt (stage.getHeight ())) };
+
+        std::vector<juce::Point<float>> points;
+        step::EaseIn x { x0, x1, 0.1f, 0.05f };
+        step::EaseIn y { y0, y1, 0.1f, 0.05f };
+        bool done { false };
+        while (!done)
+        {
+            const auto xDone { x.step (frameMs) };
+            const auto yDone { y.step (frameMs) };
+            done = xDone && yDone;
+            points.push_back ({ x.value, y.value });
+        }
+
+        auto start { juce::Time::getHighResolutionTicks () };
+        for (const auto& p : points)
+            rectangles.addRectangle (p.x, p.y, 2, 2);
+        rectangleAddNs += elapsedNs (start);
+
+        start = juce::Time::getHighResolutionTicks ();
+        for (const auto& p : points)
+            crumbs.addPoint (i, p.x, p.y);
+        crumbs.endTrail (i);
+        trailAddNs += elapsedNs (start);
+    }
+
+    juce::Image canvas { juce::Image::ARGB, stage.getWidth (), stage.getHeight (), true };
+    juce::Graphics g { canvas };
+
+    auto start { juce::Time::getHighResolutionTicks () };
+    for (int frame { 0 }; frame < kFrames; ++frame)
+        g.fillPath (rectangles);
+    const auto rectanglePaintNs { elapsedNs (start) };
+
+    start = juce::Time::getHighResolutionTicks ();
+    for (int frame { 0 }; frame < kFrames; ++frame)
+        crumbs.paint (g);
+    const auto trailPaintNs { elapsedNs (start) };
+
+    const auto points { static_cast<double> (crumbs.getPointCount ()) };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("trails", count);
+    result->setProperty ("points", static_cast<int> (crumbs.getPointCount ()));
+    result->setProperty ("vertices", static_cast<int> (crumbs.getVertexCount ()));
+    result->setProperty ("rectangleAddNsPerPoint", rectangleAddNs / points);
+    result->setProperty ("trailAddNsPerPoint", trailAddNs / points);
+    result->setProperty ("rectanglePaintNs", rectanglePaintNs / kFrames);
+    result->setProperty ("trailPaintNs", trailPaintNs / kFrames);
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runCrowd (int count)
+{
+    // keep the density the same at every size: about one box per 80x80 px.
+    const auto side { static_cast<int> (80.0 * std::sqrt (count)) };
+
+    auto makeStore = [count, side]
+    {
+        juce::Random r { 42 };
+        BoxStore store;
+        store.reserve (static_cast<size_t> (count));
+        for (int i { 0 }; i < count; ++i)
+        {
+            const auto size { static_cast<float> (r.nextInt ({ 50, 100 })) };
+            const juce::Rectangle<float> bounds { static_cast<float> (r.nextInt (side)),
+                                                  static_cast<float> (r.nextInt (side)),
+                                                  size, size };
+            store.add (i + 1, nullptr, bounds, 0, 0.9f);
+        }
+        return store;
+    };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("boxes", count);
+    result->setProperty ("naivePairChecks",
+                         static_cast<juce::int64> (count) * (count - 1));
+
+    for (auto parallel : { false, true })
+    {
+        auto store { makeStore () };
+        Crowd crowd;
+        crowd.setParallel (parallel);
+
+        juce::int64 checks { 0 };
+        juce::int64 contacts { 0 };
+        const auto start { juce::Time::getHighResolutionTicks () };
+        for (int frame { 0 }; frame < kFrames; ++frame)
+        {
+            crowd.step (store);
+            checks += crowd.getStats ().neighbourChecks;
+            contacts += crowd.getStats ().contacts;
+        }
+        const auto stepNs { elapsedNs (start) / kFrames };
+
+        const juce::String prefix { parallel ? "parallel" : "serial" };
+        result->setProperty (prefix + "StepNs", stepNs);
+        result->setProperty (prefix + "NeighbourChecks", checks / kFrames);
+        result->setProperty (prefix + "Contacts", contacts / kFrames);
+    }
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runTimerWheel (int count)
+{
+    // the default fade delay, give or take a burst's worth of spread.
+    const auto frameMs { 1000.0 / 60.0 };
+    const auto frames { static_cast<int> (2000.0 / frameMs) + 1 };
+    juce::Random r { 42 };
+    std::vector<double> delays (static_cast<size_t> (count));
+    for (auto& delay : delays)
+        delay = 1000.0 + r.nextDouble () * 1000.0;
+
+    // every waiting start is visited each frame, like a delayed friz animation.
+    std::vector<double> waiting { delays };
+    int scanFired { 0 };
+    auto start { juce::Time::getHighResolutionTicks () };
+    for (int frame { 1 }; frame <= frames; ++frame)
+    {
+        const auto now { frame * frameMs };
+        for (size_t i { 0 }; i < waiting.size ();)
+        {
+            if (waiting[i] <= now)
+            {
+                ++scanFired;
+                waiting[i] = waiting.back ();
+                waiting.pop_back ();
+            }
+            else
+                ++i;
+        }
+    }
+    const auto scanNs { elapsedNs (start) };
+
+    TimerWheel wheel;
+    int wheelFired { 0 };
+    wheel.onDue = [&wheelFired] (int) { ++wheelFired; };
+    start = juce::Time::getHighResolutionTicks ();
+    for (int i { 0 }; i < count; ++i)
+        wheel.schedule (i, delays[static_cast<size_t> (i)]);
+    for (int frame { 1 }; frame <= frames; ++frame)
+        wheel.advance (frameMs);
+    const auto wheelNs { elapsedNs (start) };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("starts", count);
+    result->setProperty ("scanFired", scanFired);
+    result->setProperty ("wheelFired", wheelFired);
+    result->setProperty ("scanNsPerFrame", scanNs / frames);
+    result->setProperty ("wheelNsPerFrame", wheelNs / frames);
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runFanOut (int count)
+{
+    const auto frameMs { 1000.f / 60.f };
+    const auto fadeMs { 1000 };
+    // boxes arrive in bursts of this many on the same frame.
+    const int burst { 100 };
+    std::vector<float> sink (static_cast<size_t> (count));
+
+    // friz: one Linear animation, and one update call, per fade.
+    friz::Animator animator;
+    for (int i { 0 }; i < count; ++i)
+    {
+        auto fade { friz::makeAnimation<friz::Linear> (i + 1, 0.9f, 0.f, fadeMs) };
+        fade->updateFn = [&sink, i] (int, const friz::Animation<1>::ValueList& val)
+        { sink[static_cast<size_t> (i)] = val[0]; };
+        animator.addAnimation (std::move (fade));
+    }
+
+    auto start { juce::Time::getHighResolutionTicks () };
+    for (int frame { 1 }; frame <= kFrames; ++frame)
+        animator.gotoTime (frame * frameMs);
+    const auto frizTickNs { elapsedNs (start) };
+    animator.cancelAllAnimations (false);
+
+    // shared: one curve evaluation per burst.
+    friz::Animator clockAnimator;
+    SharedTimeline timeline { clockAnimator, -1, static_cast<float> (fadeMs) };
+    timeline.onValues = [&sink] (const int* ids, const float* values, size_t n)
+    {
+        for (size_t i { 0 }; i < n; ++i)
+            sink[static_cast<size_t> (ids[i] - 1)] = values[i];
+    };
+    for (int i { 0 }; i < count; ++i)
+        timeline.add (i + 1, 0.9f, 0.f, static_cast<float> (i / burst) * frameMs);
+    const auto cohorts { static_cast<int> (timeline.getCohortCount ()) };
+
+    start = juce::Time::getHighResolutionTicks ();
+    for (int frame { 1 }; frame <= kFrames; ++frame)
+        clockAnimator.gotoTime (frame * frameMs);
+    const auto sharedTickNs { elapsedNs (start) };
+    timeline.clear ();
+
+    const auto perFadeFrame { static_cast<double> (count) * kFrames };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("fades", count);
+    result->setProperty ("cohorts", cohorts);
+    result->setProperty ("frizTickNsPerFade", frizTickNs / perFadeFrame);
+    result->setProperty ("sharedTickNsPerFade", sharedTickNs / perFadeFrame);
+    return juce::var (result.get ());
+}
+
+juce::var Benchmark::runSpawnQueue (int count)
+{
+    const int producers { 4 };
+    struct Record
+    {
+        int x;
+        int y;
+        int type;
+    };
+
+    // runs the producers, draining with `drain` until everything's arrived;
+    // returns the elapsed time and how many records were consumed.
+    auto run = [count, producers] (auto&& post, auto&& drain)
+    {
+        std::atomic<int> running { producers };
+        std::vector<std::thread> threads;
+        const auto start { juce::Time::getHighResolutionTicks () };
+        for (int p { 0 }; p < producers; ++p)
+        {
+            threads.emplace_back (
+                [&, p]
+                {
+                    for (int i { 0 }; i < count; ++i)
+                        post (Record { p, i, 0 });
+                    --running;
+                });
+        }
+
+        int consumed { 0 };
+        while (running.load () > 0)
+            consumed += drain ();
+        consumed += drain ();
+        for (auto& thread : threads)
+            thread.join ();
+        return std::make_pair (elapsedNs (start), consumed);
+    };
+
+    std::mutex mutex;
+    std::vector<Record> locked;
+    std::vector<Record> lockedBatch;
+    const auto [lockedNs, lockedCount] = run (
+        [&] (const Record& record)
+        {
+            const std::lock_guard<std::mutex> lock { mutex };
+            locked.push_back (record);
+        },
+        [&]
+        {
+            {
+                const std::lock_guard<std::mutex> lock { mutex };
+                lockedBatch.swap (locked);
+            }
+            const auto n { static_cast<int> (lockedBatch.size ()) };
+            lockedBatch.clear ();
+            return n;
+        });
+
+    MpscQueue<Record, 4096> queue;
+    const auto [queueNs, queueCount] = run (
+        [&] (const Record& record)
+        {
+            // a real producer would drop; here we want every record through.
+            while (!queue.push (record))
+                std::this_thread::yield ();
+        },
+        [&] { return static_cast<int> (queue.drain ([] (const Record&) {})); });
+
+    const auto total { static_cast<double> (producers) * count };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("producers", producers);
+    result->setProperty ("recordsPerProducer", count);
+    result->setProperty ("lockedConsumed", lockedCount);
+    result->setProperty ("queueConsumed", queueCount);
+    result->setProperty ("lockedNsPerRecord", lockedNs / total);
+    result->setProperty ("queueNsPerRecord", queueNs / total);
+    result->setProperty ("queueFullRetries", static_cast<int> (queue.getDropCount ()));
+    return juce::var (result.get ());
+}
@@ -0,0 +1,135 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class Benchmark
+ * @brief Headless performance measurements, run from the command line.
+ *
+ * Launching the app with `--benchmark` runs the benchmarks instead of opening
+ * the main window, and writes the results as JSON to stdout (or to the file
+ * given by `--benchmark-out=<path>`). `--benchmark=<name>[,<name>...]` limits
+ * the run to the named benchmarks.
+ */
+class Benchmark
+{
+public:
+    explicit Benchmark (const juce::String& commandLine);
+
+    /**
+     * @return true if the command line asks for a benchmark run.
+     */
+    static bool isRequested (const juce::String& commandLine);
+
+    /**
+     * Run the requested benchmarks and write the results.
+     * @return process exit code.
+     */
+    int run ();
+
+private:
+    bool wants (juce::StringRef name) const;
+
+    /**
+     * Per-frame update of `boxCount` boxes, comparing `juce::Component`s held
+     * by `unique_ptr` against the packed `BoxStore`, whose flush then moves
+     * the same components, as the demo's does. Where hardware counters
+     * are available, L1D and last-level cache misses per box are reported
+     * next to the times.
+     */
+    juce::var runBoxUpdate (int boxCount);
+
+    /**
+     * Spawn `boxCount` boxes on a `DemoComponent`, first with one call to
+     * `createDemo()` per box, then as a single `createDemos()` batch.
+     */
+    juce::var runSpawn (int boxCount);
+
+    /**
+     * Play a scripted `createDemo()` workload of `boxCount` boxes, every effect
+     * type, on a virtual clock, timing the animation update and the paint of
+     * each frame separately. This is also the training run for the Linux
+     * profile-guided build (see `Scripts/linux-pgo.sh`).
+     */
+    juce::var runFrames (int boxCount);
+
+    /**
+     * The `frames` workload again, reading hardware performance counters
+     * (see `PerfCounters`) around each phase of every frame: the animator
+     * tick, applying the updates to the boxes, painting the breadcrumbs and
+     * painting the boxes. Counts are reported per frame and per live box per
+     * frame, next to each phase's wall-clock time, which is all that's reported
+     * when the counters aren't available. `countersScaled` and `countersValid`
+     * say whether the kernel had to multiplex the counters.
+     */
+    juce::var runCounters (int boxCount);
+
+    /**
+     * Build and run `count` two-stage in/out movements, first as friz
+     * Chain/Sequence graphs, then as coroutine scripts, then as static pipelines.
+     */
+    juce::var runScript (int count);
+
+    /**
+     * Step `count` ease-in curves for a second of frames, first simulating
+     * each one, then replaying a cached trajectory.
+     */
+    juce::var runTrajectory (int count);
+
+    /**
+     * Record `count` box trails sampled at 240 Hz, then paint them; compares
+     * the original 2x2 rectangle per point against simplified polylines.
+     */
+    juce::var runBreadcrumbs (int count);
+
+    /**
+     * Step a crowd of `count` overlapping boxes, serially and in parallel, and
+     * count the neighbour checks against the n^2 of testing every pair.
+     */
+    juce::var runCrowd (int count);
+
+    /**
+     * Hold `count` delayed starts until they're due, first by checking every
+     * waiting start on every frame, then in a `TimerWheel`.
+     */
+    juce::var runTimerWheel (int count);
+
+    /**
+     * Run `count` identical fades, spawned in bursts, first as one friz
+     * animation each, then as targets on a single `SharedTimeline`.
+     */
+    juce::var runFanOut (int count);
+
+    /**
+     * Post `count` spawn records from each of several threads while one
+     * thread drains them, through a mutex-guarded vector and then through the
+     * lock-free `MpscQueue`.
+     */
+    juce::var runSpawnQueue (int count);
+
+private:
+    juce::StringArray fSelected;
+    juce::File fOutput;
+};
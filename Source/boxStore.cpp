@@ -0,0 +1,128 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "boxStore.h"
+
+namespace
+{
+template <typename T>
+void moveToSlot (std::vector<T>& vec, size_t from, size_t to)
+{
+    vec[to] = vec[from];
+    vec.pop_back ();
+}
+} // namespace
+
+void BoxStore::reserve (size_t count)
+{
+    fIds.reserve (count);
+    fViews.reserve (count);
+    fX.reserve (count);
+    fY.reserve (count);
+    fWidth.reserve (count);
+    fHeight.reserve (count);
+    fHueBucket.reserve (count);
+    fLevel.reserve (count);
+    fSaturation.reserve (count);
+    fStage.reserve (count);
+    fDirty.reserve (count);
+    fCulled.reserve (count);
+    fIndex.reserve (count);
+}
+
+void BoxStore::grow (size_t extra)
+{
+    const auto needed { fIds.size () + extra };
+    if (needed > fIds.capacity ())
+        reserve (std::max (needed, 2 * fIds.capacity ()));
+}
+
+size_t BoxStore::add (int id, juce::Component* view, juce::Rectangle<float> bounds,
+                      int hueBucket, float saturation)
+{
+    jassert (find (id) == kNotFound);
+    const auto slot { fIds.size () };
+
+    fIds.push_back (id);
+    fViews.push_back (view);
+    fX.push_back (bounds.getX ());
+    fY.push_back (bounds.getY ());
+    fWidth.push_back (bounds.getWidth ());
+    fHeight.push_back (bounds.getHeight ());
+    fHueBucket.push_back (static_cast<uint8_t> (hueBucket));
+    fLevel.push_back (static_cast<uint8_t> (ColourRamp::getLevel (saturation)));
+    fSaturation.push_back (saturation);
+    fStage.push_back (Stage::kMoving);
+    fDirty.push_back (kClean);
+    fCulled.push_back (0);
+
+    fIndex[id] = slot;
+    return slot;
+}
+
+bool BoxStore::remove (int id)
+{
+    const auto slot { find (id) };
+    if (slot == kNotFound)
+        return false;
+
+    if (fCulled[slot] != 0)
+        --fCulledCount;
+
+    const auto last { fIds.size () - 1 };
+    if (slot != last)
+        fIndex[fIds[last]] = slot;
+    fIndex.erase (id);
+
+    moveToSlot (fIds, last, slot);
+    moveToSlot (fViews, last, slot);
+    moveToSlot (fX, last, slot);
+    moveToSlot (fY, last, slot);
+    moveToSlot (fWidth, last, slot);
+    moveToSlot (fHeight, last, slot);
+    moveToSlot (fHueBucket, last, slot);
+    moveToSlot (fLevel, last, slot);
+    moveToSlot (fSaturation, last, slot);
+    moveToSlot (fStage, last, slot);
+    moveToSlot (fDirty, last, slot);
+    moveToSlot (fCulled, last, slot);
+
+    return true;
+}
+
+void BoxStore::clear ()
+{
+    fIds.clear ();
+    fViews.clear ();
+    fX.clear ();
+    fY.clear ();
+    fWidth.clear ();
+    fHeight.clear ();
+    fHueBucket.clear ();
+    fLevel.clear ();
+    fSaturation.clear ();
+    fStage.clear ();
+    fDirty.clear ();
+    fCulled.clear ();
+    fCulledCount = 0;
+    fIndex.clear ();
+}
@@ -0,0 +1,215 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+#include "colourRamp.h"
+
+/**
+ * @class BoxStore
+ * @brief Packed storage for the per-frame state of every box on the stage.
+ *
+ * Rather than scattering each box's position and color through a heavyweight
+ * `juce::Component`, we keep the values that change every frame in
+ * contiguous parallel arrays, indexed by a slot number. Animation callbacks
+ * write into the arrays (finding the slot for a box id is O(1)) and mark the
+ * slot dirty; once per frame `flush()` streams linearly through the dirty flags
+ * and pushes the changes out to whatever views are attached.
+ *
+ * Colors are stored as a `ColourRamp` hue bucket plus a quantised saturation
+ * level; a saturation change that doesn't change the level doesn't dirty the box.
+ *
+ * Boxes can be marked as culled (nothing of them is visible); the store keeps a
+ * running count of them for profiling.
+ *
+ * Removing a box moves the last box into its slot so the arrays stay packed;
+ * slot numbers are therefore only stable until the next call to `remove()`.
+ */
+class BoxStore
+{
+public:
+    enum class Stage : uint8_t
+    {
+        kMoving = 0,
+        kWaiting,
+        kFading
+    };
+
+    enum Dirty : uint8_t
+    {
+        kClean    = 0,
+        kPosition = 1 << 0,
+        kColor    = 1 << 1,
+        /// nothing about the box changed, but its visibility may have.
+        kVisibility = 1 << 2
+    };
+
+    static constexpr size_t kNotFound { std::numeric_limits<size_t>::max () };
+
+    void reserve (size_t count);
+
+    /**
+     * Make room for `extra` more boxes, growing geometrically so that
+     * repeatedly adding small batches doesn't reallocate every time.
+     */
+    void grow (size_t extra);
+
+    /**
+     * Add a box to the store.
+     * @param  id     unique id of the box
+     * @param  view   (non-owning) component that displays this box, may be nullptr
+     * @param  bounds initial position/size
+     * @param  hueBucket  `ColourRamp` bucket of the box's hue
+     * @param  saturation 0..1
+     * @return        slot index of the new box.
+     */
+    size_t add (int id, juce::Component* view, juce::Rectangle<float> bounds,
+                int hueBucket, float saturation);
+
+    /**
+     * Remove a box, moving the last box into its slot.
+     * @return false if there's no box with that id.
+     */
+    bool remove (int id);
+
+    void clear ();
+
+    /**
+     * @return slot of the box with this id, or `kNotFound`.
+     */
+    size_t find (int id) const
+    {
+        const auto it { fIndex.find (id) };
+        return (it == fIndex.end ()) ? kNotFound : it->second;
+    }
+
+    size_t size () const { return fIds.size (); }
+
+    void setPosition (size_t slot, float x, float y)
+    {
+        fX[slot] = x;
+        fY[slot] = y;
+        fDirty[slot] |= kPosition;
+    }
+
+    /**
+     * Update a box's saturation.
+     * @return true if the box's quantised color changed and needs to be redrawn.
+     */
+    bool setSaturation (size_t slot, float saturation)
+    {
+        fSaturation[slot] = saturation;
+        const auto level { static_cast<uint8_t> (ColourRamp::getLevel (saturation)) };
+        if (level == fLevel[slot])
+            return false;
+
+        fLevel[slot] = level;
+        fDirty[slot] |= kColor;
+        return true;
+    }
+
+    void setStage (size_t slot, Stage stage) { fStage[slot] = stage; }
+
+    /**
+     * Mark every box dirty, e.g. so that they're all re-checked for visibility.
+     */
+    void markAll (uint8_t flags)
+    {
+        for (auto& dirty : fDirty)
+            dirty |= flags;
+    }
+
+    /**
+     * @return true if this changed the box's culled state.
+     */
+    bool setCulled (size_t slot, bool culled)
+    {
+        if ((fCulled[slot] != 0) == culled)
+            return false;
+
+        fCulled[slot] = culled ? 1 : 0;
+        if (culled)
+            ++fCulledCount;
+        else
+            --fCulledCount;
+        return true;
+    }
+
+    bool isCulled (size_t slot) const { return fCulled[slot] != 0; }
+    size_t getCulledCount () const { return fCulledCount; }
+
+    int getId (size_t slot) const { return fIds[slot]; }
+    juce::Component* getView (size_t slot) const { return fViews[slot]; }
+    float getX (size_t slot) const { return fX[slot]; }
+    float getY (size_t slot) const { return fY[slot]; }
+    float getWidth (size_t slot) const { return fWidth[slot]; }
+    float getHeight (size_t slot) const { return fHeight[slot]; }
+    int getHueBucket (size_t slot) const { return fHueBucket[slot]; }
+    int getLevel (size_t slot) const { return fLevel[slot]; }
+    float getSaturation (size_t slot) const { return fSaturation[slot]; }
+    Stage getStage (size_t slot) const { return fStage[slot]; }
+
+    /**
+     * Call `fn (slot, dirtyFlags)` for every slot that's changed since the last
+     * flush, then mark everything clean.
+     */
+    template <typename Fn>
+    void flush (Fn&& fn)
+    {
+        const auto count { fDirty.size () };
+        for (size_t slot { 0 }; slot < count; ++slot)
+        {
+            if (const auto flags { fDirty[slot] }; flags != kClean)
+            {
+                fDirty[slot] = kClean;
+                fn (slot, flags);
+            }
+        }
+    }
+
+    /**
+     * @return number of bytes of array storage used by each box.
+     */
+    static constexpr size_t bytesPerBox ()
+    {
+        return sizeof (int) + sizeof (juce::Component*) + 5 * sizeof (float) +
+               2 * sizeof (uint8_t) + sizeof (Stage) + 2 * sizeof (uint8_t);
+    }
+
+private:
+    std::vector<int> fIds;
+    std::vector<juce::Component*> fViews;
+    std::vector<float> fX;
+    std::vector<float> fY;
+    std::vector<float> fWidth;
+    std::vector<float> fHeight;
+    std::vector<uint8_t> fHueBucket;
+    std::vector<uint8_t> fLevel;
+    std::vector<float> fSaturation;
+    std::vector<Stage> fStage;
+    std::vector<uint8_t> fDirty;
+    std::vector<uint8_t> fCulled;
+    size_t fCulledCount { 0 };
+
+    std::unordered_map<int, size_t> fIndex;
+};
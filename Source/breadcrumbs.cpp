@@ -20,3 +20,337 @@
     SOFTWARE.
 */
 #include "breadcrumbs.h"
+
+#include <array>
+#include <cmath>
+
+namespace
+{
+// trails are simplified to within this many pixels; half a pixel is
+// indistinguishable from the original at 1:1.
+const float kMinTolerance { 0.5f };
+const float kMaxTolerance { 4.f };
+
+// frame rates (fps) below/above which we coarsen/refine the trails.
+const float kSlowFrameRate { 50.f };
+const float kFastFrameRate { 57.f };
+
+// round joins and caps, so a trail stroked one segment at a time looks the same
+// as one stroked all at once, and a single point still shows as a dot.
+const juce::PathStrokeType kTrailStroke { 2.f, juce::PathStrokeType::curved,
+                                          juce::PathStrokeType::rounded };
+
+// crumbs were first drawn as 2x2 squares with their top left corner at the
+// point, so a crumb's centre is a pixel down and to the right of it.
+juce::Point<float> toCentre (juce::Point<float> point)
+{
+    return point.translated (1.f, 1.f);
+}
+
+/**
+ * Douglas-Peucker: keep only the vertices needed to stay within `tolerance`
+ * of the original polyline.
+ */
+std::vector<juce::Point<float>> simplify (const std::vector<juce::Point<float>>& points,
+                                          float tolerance)
+{
+    if (points.size () < 3)
+        return points;
+
+    std::vector<bool> keep (points.size (), false);
+    keep.front () = true;
+    keep.back ()  = true;
+
+    std::vector<std::pair<size_t, size_t>> spans { { 0, points.size () - 1 } };
+    while (!spans.empty ())
+    {
+        const auto [first, last] { spans.back () };
+        spans.pop_back ();
+
+        const juce::Line<float> chord { points[first], points[last] };
+        float furthest { 0.f };
+        size_t index { first };
+        for (size_t i { first + 1 }; i < last; ++i)
+        {
+            juce::Point<float> nearest;
+            const auto distance { chord.getDistanceFromPoint (points[i], nearest) };
+            if (distance > furthest)
+            {
+                furthest = distance;
+                index    = i;
+            }
+        }
+
+        if (furthest > tolerance)
+        {
+            keep[index] = true;
+            spans.push_back ({ first, index });
+            spans.push_back ({ index, last });
+        }
+    }
+
+    std::vector<juce::Point<float>> kept;
+    for (size_t i { 0 }; i < points.size (); ++i)
+    {
+        if (keep[i])
+            kept.push_back (points[i]);
+    }
+    return kept;
+}
+
+juce::Path toPath (const std::vector<juce::Point<float>>& points)
+{
+    juce::Path path;
+    if (points.empty ())
+        return path;
+
+    path.startNewSubPath (toCentre (points.front ()));
+    for (size_t i { 1 }; i < points.size (); ++i)
+        path.lineTo (toCentre (points[i]));
+    if (points.size () == 1)
+        path.lineTo (toCentre (points.front ()));
+    return path;
+}
+
+/**
+ * Maps heat (0..1) to a colour: cool and translucent for rarely visited cells,
+ * through to hot and opaque for the busiest.
+ */
+const std::array<juce::PixelARGB, 256>& getPalette ()
+{
+    static const auto palette = []
+    {
+        const std::array<juce::Colour, 5> stops { juce::Colours::blue.withAlpha (0.f),
+                                                  juce::Colours::blue.withAlpha (0.5f),
+                                                  juce::Colours::cyan.withAlpha (0.7f),
+                                                  juce::Colours::yellow.withAlpha (0.85f),
+                                                  juce::Colours::red };
+        std::array<juce::PixelARGB, 256> lut;
+        const auto segments { static_cast<float> (stops.size () - 1) };
+        for (size_t i { 0 }; i < lut.size (); ++i)
+        {
+            const auto pos { static_cast<float> (i) / 255.f * segments };
+            const auto stop { std::min (static_cast<size_t> (pos), stops.size () - 2) };
+            const auto colour { stops[stop].interpolatedWith (
+                stops[stop + 1], pos - static_cast<float> (stop)) };
+            lut[i] = colour.getPixelARGB ();
+        }
+        return lut;
+    }();
+    return palette;
+}
+
+juce::AffineTransform getCellTransform ()
+{
+    return juce::AffineTransform::scale (static_cast<float> (Breadcrumbs::kCellSize));
+}
+} // namespace
+
+Breadcrumbs::Breadcrumbs ()
+: fEnabled (true)
+, fTolerance (kMinTolerance)
+{
+    // ignore all mouse clicks.
+    setInterceptsMouseClicks (false, false);
+}
+
+void Breadcrumbs::addPoint (int trailId, float x, float y)
+{
+    if (!fEnabled)
+        return;
+
+    ++fPointCount;
+    auto& trail { fTrails[trailId] };
+    if (trail.toSkip > 0)
+    {
+        --trail.toSkip;
+        trail.skipped = juce::Point<float> { x, y };
+        return;
+    }
+
+    trail.toSkip  = fKeepEvery - 1;
+    trail.skipped = std::nullopt;
+    record (trail, { x, y });
+}
+
+void Breadcrumbs::record (Trail& trail, juce::Point<float> point)
+{
+    if (Mode::kPath == fMode)
+    {
+        // crumbs are drawn on whole pixels, so anything closer than that is a
+        // repeat of the last one.
+        const juce::Point<float> snapped { std::round (point.x), std::round (point.y) };
+        if (trail.points.empty () || trail.points.back () != snapped)
+        {
+            // stroke just the new segment onto the trail's cached outline, so
+            // painting a live trail doesn't rebuild it from all of its points.
+            const auto from { trail.points.empty () ? snapped : trail.points.back () };
+            trail.points.push_back (snapped);
+
+            juce::Path segment;
+            segment.startNewSubPath (toCentre (from));
+            segment.lineTo (toCentre (snapped));
+            juce::Path stroked;
+            kTrailStroke.createStrokedPath (stroked, segment);
+            trail.stroked.addPath (stroked);
+        }
+    }
+
+    const auto col { static_cast<int> (point.x) / kCellSize };
+    const auto row { static_cast<int> (point.y) / kCellSize };
+    if (col >= 0 && col < fCols && row >= 0 && row < fRows)
+    {
+        const auto count { ++fCounts[static_cast<size_t> (row * fCols + col)] };
+        fMaxCount     = std::max (fMaxCount, count);
+        fHeatmapDirty = true;
+    }
+}
+
+void Breadcrumbs::endTrail (int trailId)
+{
+    const auto it { fTrails.find (trailId) };
+    if (it == fTrails.end ())
+        return;
+
+    auto trail { std::move (it->second) };
+    fTrails.erase (it);
+
+    // every trail keeps its exact end point, however thinly it was sampled.
+    if (trail.skipped)
+        record (trail, *trail.skipped);
+    if (trail.points.empty ())
+        return;
+
+    const auto kept { simplify (trail.points, fTolerance) };
+    fVertexCount += kept.size ();
+
+    juce::Path stroked;
+    kTrailStroke.createStrokedPath (stroked, toPath (kept));
+    fBreadcrumbs.addPath (stroked);
+}
+
+void Breadcrumbs::adaptDetail (float framesPerSecond)
+{
+    if (framesPerSecond <= 0.f)
+        return;
+
+    if (framesPerSecond < kSlowFrameRate)
+        fTolerance = std::min (fTolerance * 1.5f, kMaxTolerance);
+    else if (framesPerSecond > kFastFrameRate)
+        fTolerance = std::max (fTolerance / 1.5f, kMinTolerance);
+}
+
+void Breadcrumbs::setMode (Mode mode)
+{
+    if (mode != fMode)
+    {
+        fMode = mode;
+        // the trails are only collected in path mode, so don't show partial ones.
+        fBreadcrumbs.clear ();
+        fTrails.clear ();
+        repaint ();
+    }
+}
+
+void Breadcrumbs::clear ()
+{
+    fBreadcrumbs.clear ();
+    fTrails.clear ();
+    fPointCount  = 0;
+    fVertexCount = 0;
+    std::fill (fCounts.begin (), fCounts.end (), 0u);
+    fMaxCount     = 0;
+    fHeatmapDirty = true;
+}
+
+void Breadcrumbs::paint (juce::Graphics& g)
+{
+    if (!fEnabled)
+        return;
+
+    if (Mode::kPath == fMode)
+    {
+        g.setColour (juce::Colours::black);
+        g.fillPath (fBreadcrumbs);
+        for (const auto& [id, trail] : fTrails)
+            g.fillPath (trail.stroked);
+    }
+    else if (const auto& heatmap { getHeatmap () }; heatmap.isValid ())
+    {
+        g.setImageResamplingQuality (juce::Graphics::lowResamplingQuality);
+        g.drawImageTransformed (heatmap, getCellTransform ());
+    }
+}
+
+void Breadcrumbs::resized ()
+{
+    const auto cols { (getWidth () + kCellSize - 1) / kCellSize };
+    const auto rows { (getHeight () + kCellSize - 1) / kCellSize };
+    if (cols == fCols && rows == fRows)
+        return;
+
+    fCols = cols;
+    fRows = rows;
+    fCounts.assign (static_cast<size_t> (fCols * fRows), 0u);
+    fMaxCount     = 0;
+    fHeatmap      = {};
+    fHeatmapDirty = true;
+}
+
+bool Breadcrumbs::exportPng (const juce::File& file)
+{
+    const auto& heatmap { getHeatmap () };
+    if (!heatmap.isValid ())
+        return false;
+
+    juce::Image image { juce::Image::ARGB, getWidth (), getHeight (), true };
+    {
+        juce::Graphics g { image };
+        g.fillAll (juce::Colours::white);
+        g.setImageResamplingQuality (juce::Graphics::lowResamplingQuality);
+        g.drawImageTransformed (heatmap, getCellTransform ());
+    }
+
+    file.deleteFile ();
+    juce::FileOutputStream stream { file };
+    if (!stream.openedOk ())
+        return false;
+
+    juce::PNGImageFormat png;
+    return png.writeImageToStream (image, stream);
+}
+
+const juce::Image& Breadcrumbs::getHeatmap ()
+{
+    if (fCols == 0 || fRows == 0)
+    {
+        fHeatmap = {};
+        return fHeatmap;
+    }
+
+    if (!fHeatmap.isValid ())
+        fHeatmap = juce::Image (juce::Image::ARGB, fCols, fRows, true);
+
+    if (fHeatmapDirty)
+    {
+        // log scale, so that a few very busy cells don't wash out the rest.
+        const auto& palette { getPalette () };
+        const auto maxHeat { std::log1p (static_cast<float> (fMaxCount)) };
+        const auto scale { fMaxCount > 0 ? 255.f / maxHeat : 0.f };
+
+        juce::Image::BitmapData pixels { fHeatmap, juce::Image::BitmapData::writeOnly };
+        for (int row { 0 }; row < fRows; ++row)
+        {
+            const auto* counts { fCounts.data () + row * fCols };
+            for (int col { 0 }; col < fCols; ++col)
+            {
+                const auto heat { std::log1p (static_cast<float> (counts[col])) * scale };
+                auto* pixel { reinterpret_cast<juce::PixelARGB*> (
+                    pixels.getPixelPointer (col, row)) };
+                *pixel = palette[static_cast<size_t> (juce::jlimit (0.f, 255.f, heat))];
+            }
+        }
+        fHeatmapDirty = false;
+    }
+    return fHeatmap;
+}
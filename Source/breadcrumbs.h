@@ -24,15 +24,34 @@
 
 #include "animatorApp.h"
 
+#include <optional>
+
+/**
+ * @class Breadcrumbs
+ * @brief Marks everywhere the boxes have been.
+ *
+ * Every point is also counted in a fixed-resolution density grid the size of
+ * the stage, so memory use doesn't grow with the length of the session. The
+ * crumbs can be drawn either as a polyline trail per box, or as a colour-mapped
+ * heatmap of the grid, in which case the trails' points aren't kept at all.
+ *
+ * Trail points are snapped to whole pixels and repeats dropped as they arrive;
+ * when a box's trail is finished it's simplified (Douglas-Peucker) to within
+ * the current detail tolerance, which widens when frames are running late.
+ */
 class Breadcrumbs : public juce::Component
 {
 public:
-    Breadcrumbs ()
-    : fEnabled (true)
+    enum class Mode
     {
-        // ignore all mouse clicks.
-        setInterceptsMouseClicks (false, false);
-    }
+        kPath = 0,
+        kHeatmap
+    };
+
+    /// each grid cell covers this many pixels in each direction.
+    static constexpr int kCellSize { 4 };
+
+    Breadcrumbs ();
 
     void enable (bool isEnabled)
     {
@@ -42,27 +61,97 @@ public:
 
     bool isEnabled () const { return fEnabled; }
 
-    void clear () { fBreadcrumbs.clear (); }
+    void setMode (Mode mode);
 
-    void addPoint (float x, float y)
-    {
-        if (fEnabled)
-        {
-            fBreadcrumbs.addRectangle (x, y, 2, 2);
-        }
-    }
+    Mode getMode () const { return fMode; }
 
-    void paint (juce::Graphics& g) override
-    {
-        if (fEnabled)
-        {
-            g.setColour (juce::Colours::black);
-            g.fillPath (fBreadcrumbs);
-        }
-    }
+    void clear ();
+
+    /**
+     * Add a point to the trail with id `trailId` (normally a box id).
+     */
+    void addPoint (int trailId, float x, float y);
+
+    /**
+     * The trail with this id is complete; simplify it and stop tracking it.
+     */
+    void endTrail (int trailId);
+
+    /**
+     * Adjust the simplification tolerance to the measured frame rate: coarser
+     * trails when we're missing frames, back toward pixel-exact when we aren't.
+     */
+    void adaptDetail (float framesPerSecond);
+
+    float getTolerance () const { return fTolerance; }
+
+    /**
+     * Only record one in every `keepEvery` points of each trail (1 records
+     * them all). A trail's first and last points are always recorded.
+     */
+    void setThinning (int keepEvery) { fKeepEvery = std::max (1, keepEvery); }
+
+    /**
+     * @return number of points passed to `addPoint ()` and the number of
+     *         vertices kept in the trails, since the last `clear ()`.
+     */
+    size_t getPointCount () const { return fPointCount; }
+    size_t getVertexCount () const { return fVertexCount; }
+
+    void paint (juce::Graphics& g) override;
+
+    /**
+     * Resizing the stage starts a new, empty density grid.
+     */
+    void resized () override;
+
+    /**
+     * Write the density grid as a heatmap at the stage's size.
+     * @return false if the file couldn't be written.
+     */
+    bool exportPng (const juce::File& file);
+
+private:
+    /**
+     * Re-colour the heatmap image from the grid if it's changed.
+     */
+    const juce::Image& getHeatmap ();
 
 private:
+    struct Trail
+    {
+        /// empty in heatmap mode.
+        std::vector<juce::Point<float>> points;
+        /// outline of the trail so far, extended a segment at a time.
+        juce::Path stroked;
+        /// how many more points to thin out before the next one is recorded.
+        int toSkip { 0 };
+        /// the last point thinned out, recorded after all if the trail ends on it.
+        std::optional<juce::Point<float>> skipped;
+    };
+
+    /**
+     * Add a point that's made it past the thinning to its trail and the grid.
+     */
+    void record (Trail& trail, juce::Point<float> point);
+
+    /// finished trails, already stroked and ready to fill.
     juce::Path fBreadcrumbs;
+    /// trails still being added to, by id (in either mode, for the thinning).
+    std::unordered_map<int, Trail> fTrails;
+    size_t fPointCount { 0 };
+    size_t fVertexCount { 0 };
 
     bool fEnabled;
+    Mode fMode { Mode::kPath };
+    float fTolerance;
+    int fKeepEvery { 1 };
+
+    std::vector<uint32_t> fCounts;
+    int fCols { 0 };
+    int fRows { 0 };
+    uint32_t fMaxCount { 0 };
+
+    juce::Image fHeatmap;
+    bool fHeatmapDirty { false };
 };
@@ -0,0 +1,52 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "colourRamp.h"
+
+ColourRamp::ColourRamp (float brightness, float alpha)
+: fBrightness { brightness }
+, fAlpha { alpha }
+, fTable (static_cast<size_t> (kHueBuckets * kLevels))
+, fBuilt (static_cast<size_t> (kHueBuckets), false)
+{
+}
+
+void ColourRamp::prepare (int bucket)
+{
+    jassert (juce::isPositiveAndBelow (bucket, kHueBuckets));
+    if (fBuilt[static_cast<size_t> (bucket)])
+        return;
+
+    const auto hue { (static_cast<float> (bucket) + 0.5f) / kHueBuckets };
+    for (int level { 0 }; level < kLevels; ++level)
+    {
+        const auto saturation { static_cast<float> (level) / (kLevels - 1) };
+        fTable[static_cast<size_t> (bucket * kLevels + level)] =
+            juce::Colour (hue, saturation, fBrightness, fAlpha);
+    }
+    fBuilt[static_cast<size_t> (bucket)] = true;
+}
+
+int ColourRamp::getBucket (float hue)
+{
+    return juce::jlimit (0, kHueBuckets - 1, static_cast<int> (hue * kHueBuckets));
+}
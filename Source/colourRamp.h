@@ -0,0 +1,77 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class ColourRamp
+ * @brief Precomputed, quantised saturation ramps for the box colors.
+ *
+ * Box hues are snapped to one of `kHueBuckets` buckets. The first time a box
+ * in a bucket is created, we fill in that bucket's ramp of `kLevels` colors
+ * running from fully desaturated to fully saturated. After that, fading a box
+ * is just a table lookup, with no RGB->HSB->RGB round trip. Since the ramp is
+ * quantised, callers can also skip repainting when a saturation change doesn't
+ * move a box to a different level.
+ */
+class ColourRamp
+{
+public:
+    static constexpr int kHueBuckets { 64 };
+    static constexpr int kLevels { 64 };
+
+    ColourRamp (float brightness, float alpha);
+
+    /**
+     * Make sure the ramp for `bucket` has been built.
+     */
+    void prepare (int bucket);
+
+    /**
+     * @return the bucket to use for a hue in the range 0..1
+     */
+    static int getBucket (float hue);
+
+    /**
+     * @return the quantised level for a saturation in the range 0..1
+     */
+    static int getLevel (float saturation)
+    {
+        return juce::jlimit (0, kLevels - 1,
+                             static_cast<int> (saturation * (kLevels - 1) + 0.5f));
+    }
+
+    juce::Colour getColour (int bucket, int level) const
+    {
+        jassert (fBuilt[static_cast<size_t> (bucket)]);
+        return fTable[static_cast<size_t> (bucket * kLevels + level)];
+    }
+
+private:
+    float fBrightness;
+    float fAlpha;
+
+    std::vector<juce::Colour> fTable;
+    std::vector<bool> fBuilt;
+};
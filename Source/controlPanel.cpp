@@ -26,7 +26,12 @@
 ControlPanel::ControlPanel (juce::ValueTree params)
 : fControls (params)
 {
-    addAndMakeVisible (fControls);
+    fViewport.setViewedComponent (&fControls, false);
+    fViewport.setScrollBarsShown (true, false);
+    addAndMakeVisible (fViewport);
+
+    // we fill our entire bounds, so nothing behind us needs to be painted.
+    setOpaque (true);
 }
 
 ControlPanel::~ControlPanel () {}
@@ -46,7 +51,11 @@ void ControlPanel::resized ()
 
     auto bounds = getLocalBounds ();
     bounds.removeFromLeft (30);
-    fControls.setBounds (bounds);
+    fViewport.setBounds (bounds);
+    // the well keeps its natural height; the viewport scrolls when that's too tall.
+    fControls.setSize (fViewport.getMaximumVisibleWidth (),
+                       juce::jmax (fControls.getContentHeight (),
+                                   fViewport.getMaximumVisibleHeight ()));
 }
 
 void ControlPanel::mouseDown (const juce::MouseEvent& /*e*/)
@@ -183,6 +192,27 @@ ControlWell::ControlWell (juce::ValueTree params)
 : fTree (params)
 {
     addControl (std::make_unique<VtCheck> (fTree, ID::kBreadcrumbs, "Show Breadcrumbs"));
+    addControl (
+        std::make_unique<VtCheck> (fTree, ID::kHeatmap, "Breadcrumbs as Heatmap"));
+    addControl (
+        std::make_unique<VtCheck> (fTree, ID::kCacheBoxLayers, "Cache Moving Boxes"));
+    addControl (std::make_unique<VtCheck> (fTree, ID::kCrowd, "Boxes Push Each Other"));
+    addControl (
+        std::make_unique<VtCheck> (fTree, ID::kCrowdParallel, "...Using All Cores"));
+    addControl (std::make_unique<VtCheck> (fTree, ID::kInspector, "Show Cost Inspector"));
+    addControl (std::make_unique<VtCheck> (fTree, ID::kSprayMode, "Spray Boxes on Drag"));
+    addControl (std::make_unique<VtLabel> (false, "Boxes per Drag Event"));
+    addControl (std::make_unique<VtSlider> (fTree, 1.f, 200.f, true, ID::kSprayCount));
+    addControl (std::make_unique<VtLabel> (false, "Run In/Out Boxes As"));
+    {
+        // (these match DemoComponent::InOutDriver)
+        auto driver { std::make_unique<VtComboBox> (fTree, ID::kInOutDriver) };
+        driver->addSelection (0, "friz Chain");
+        driver->addSelection (1, "Coroutine Script");
+        driver->addSelection (2, "Static Pipeline");
+        driver->update ();
+        addControl (std::move (driver));
+    }
     addControl (std::make_unique<VtLabel> (true, "Parametric - [click]"));
     addControl (std::make_unique<VtLabel> (false, "Curve"));
 
@@ -296,6 +326,14 @@ void ControlWell::resized ()
     }
 }
 
+int ControlWell::getContentHeight () const
+{
+    int height { 0 };
+    for (const auto& c : fControls)
+        height += c->getHeight ();
+    return height;
+}
+
 void ControlWell::paint (juce::Graphics& g)
 {
     g.fillAll (juce::Colour (0xFF505050));
@@ -86,6 +86,11 @@ public:
 
     void paint (juce::Graphics& g) override;
 
+    /**
+     * @return Height needed to stack every control without clipping.
+     */
+    int getContentHeight () const;
+
 private:
     void addControl (std::unique_ptr<juce::Component> control);
 
@@ -108,6 +113,8 @@ public:
 
 private:
     ControlWell fControls;
+    /// The well is taller than the window; it scrolls inside this viewport.
+    juce::Viewport fViewport;
 
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ControlPanel)
@@ -0,0 +1,126 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "costProfiler.h"
+
+namespace
+{
+double ticksToMs (double ticks)
+{
+    const auto perSecond { juce::Time::getHighResolutionTicksPerSecond () };
+    return ticks * 1000.0 / static_cast<double> (perSecond);
+}
+} // namespace
+
+const char* CostProfiler::getName (Category category)
+{
+    switch (category)
+    {
+        case kLinear: return "Linear";
+        case kParametric: return "Parametric";
+        case kEaseIn: return "Ease In";
+        case kEaseOut: return "Ease Out";
+        case kSpring: return "Spring";
+        case kInOutChain: return "In/Out (friz)";
+        case kInOutScript: return "In/Out (script)";
+        case kInOutPipeline: return "In/Out (pipeline)";
+        case kFade: return "Fade timeline";
+        case kCrowd: return "Crowd";
+        case kNumCategories: break;
+    }
+    return "?";
+}
+
+void CostProfiler::setEnabled (bool enabled)
+{
+    if (enabled == fEnabled)
+        return;
+
+    fEnabled = enabled;
+    fFrames  = 0;
+    fFrameTicks.fill (0);
+    fFrameHasWork = false;
+    fWindowTicks.fill (0);
+    fWindowMaxTicks.fill (0);
+    fWindowCalls.fill (0);
+    fById.clear ();
+    fReport = {};
+}
+
+void CostProfiler::add (Category category, int id, juce::int64 ticks)
+{
+    fFrameTicks[category] += ticks;
+    ++fWindowCalls[category];
+    fFrameHasWork = true;
+
+    const auto key { (static_cast<juce::uint64> (category) << 32) |
+                     static_cast<juce::uint32> (id) };
+    auto [it, inserted] = fById.try_emplace (key, Cost { id, category, 0 });
+    it->second.ticks += ticks;
+}
+
+void CostProfiler::endFrame ()
+{
+    if (!fEnabled || !fFrameHasWork)
+        return;
+
+    for (size_t c { 0 }; c < kNumCategories; ++c)
+    {
+        fWindowTicks[c] += fFrameTicks[c];
+        fWindowMaxTicks[c] = std::max (fWindowMaxTicks[c], fFrameTicks[c]);
+    }
+    fFrameTicks.fill (0);
+    fFrameHasWork = false;
+
+    if (++fFrames >= kWindowFrames)
+        publish ();
+}
+
+void CostProfiler::publish ()
+{
+    const auto frames { static_cast<double> (fFrames) };
+    for (size_t c { 0 }; c < kNumCategories; ++c)
+    {
+        auto& row { fReport.rows[c] };
+        row.callsPerFrame = static_cast<double> (fWindowCalls[c]) / frames;
+        row.averageMs     = ticksToMs (static_cast<double> (fWindowTicks[c])) / frames;
+        row.maxMs         = ticksToMs (static_cast<double> (fWindowMaxTicks[c]));
+    }
+
+    std::vector<Hotspot> all;
+    all.reserve (fById.size ());
+    for (const auto& [key, cost] : fById)
+        all.push_back ({ cost.id, cost.category,
+                         ticksToMs (static_cast<double> (cost.ticks)) / frames });
+    const auto count { std::min (kTopCount, all.size ()) };
+    std::partial_sort (all.begin (), all.begin () + static_cast<std::ptrdiff_t> (count),
+                       all.end (),
+                       [] (const Hotspot& a, const Hotspot& b) { return a.ms > b.ms; });
+    all.resize (count);
+    fReport.top = std::move (all);
+
+    fFrames = 0;
+    fWindowTicks.fill (0);
+    fWindowMaxTicks.fill (0);
+    fWindowCalls.fill (0);
+    fById.clear ();
+}
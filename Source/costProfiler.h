@@ -0,0 +1,156 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class CostProfiler
+ * @brief Attributes per-frame animation work to the kind of animation doing it.
+ *
+ * The stage wraps each of its per-frame callbacks in a `Scope` naming the cost
+ * category (one per effect type, plus each way of running the in/out effect,
+ * the shared fade timeline, and the crowd) and the id of the animation. Costs
+ * are totalled per frame; every `kWindowFrames` frames the totals are folded
+ * into a `Report` with the average and worst frame for each category and the
+ * animations that cost the most over the window.
+ *
+ * When disabled, a `Scope` is a single branch.
+ */
+class CostProfiler
+{
+public:
+    enum Category
+    {
+        kLinear = 0,
+        kParametric,
+        kEaseIn,
+        kEaseOut,
+        kSpring,
+        kInOutChain,
+        kInOutScript,
+        kInOutPipeline,
+        kFade,
+        kCrowd,
+        kNumCategories
+    };
+
+    static const char* getName (Category category);
+
+    static constexpr int kWindowFrames { 60 };
+    static constexpr size_t kTopCount { 8 };
+
+    struct Row
+    {
+        /// filled in by whoever owns the animations.
+        int live { 0 };
+        double callsPerFrame { 0.0 };
+        double averageMs { 0.0 };
+        double maxMs { 0.0 };
+    };
+
+    struct Hotspot
+    {
+        int id;
+        Category category;
+        /// average cost per frame over the window.
+        double ms;
+    };
+
+    struct Report
+    {
+        std::array<Row, kNumCategories> rows;
+        std::vector<Hotspot> top;
+    };
+
+    /**
+     * Times everything between its construction and destruction.
+     */
+    class Scope
+    {
+    public:
+        Scope (CostProfiler& profiler, Category category, int id)
+        : fProfiler (profiler.isEnabled () ? &profiler : nullptr)
+        , fCategory (category)
+        , fId (id)
+        , fStart (fProfiler != nullptr ? juce::Time::getHighResolutionTicks () : 0)
+        {
+        }
+
+        ~Scope ()
+        {
+            if (fProfiler != nullptr)
+                fProfiler->add (fCategory, fId,
+                                juce::Time::getHighResolutionTicks () - fStart);
+        }
+
+    private:
+        CostProfiler* fProfiler;
+        Category fCategory;
+        int fId;
+        juce::int64 fStart;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    void setEnabled (bool enabled);
+    bool isEnabled () const { return fEnabled; }
+
+    void add (Category category, int id, juce::int64 ticks);
+
+    /**
+     * Close off the current frame.
+     */
+    void endFrame ();
+
+    /**
+     * @return the report for the most recently completed window.
+     */
+    const Report& getReport () const { return fReport; }
+
+private:
+    void publish ();
+
+private:
+    bool fEnabled { false };
+    int fFrames { 0 };
+
+    // this frame
+    std::array<juce::int64, kNumCategories> fFrameTicks {};
+    bool fFrameHasWork { false };
+
+    // this window
+    std::array<juce::int64, kNumCategories> fWindowTicks {};
+    std::array<juce::int64, kNumCategories> fWindowMaxTicks {};
+    std::array<juce::int64, kNumCategories> fWindowCalls {};
+    struct Cost
+    {
+        int id;
+        Category category;
+        juce::int64 ticks;
+    };
+    /// keyed on category and id together; the shared categories all use id 0.
+    std::unordered_map<juce::uint64, Cost> fById;
+
+    Report fReport;
+};
@@ -0,0 +1,173 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "crowd.h"
+
+#include <thread>
+
+namespace
+{
+// no box is bigger than this, so overlapping boxes are always in neighbouring
+// cells of the spatial hash.
+const float kCellSize { 100.f };
+
+// fraction of the overlap each box of a pair moves per step.
+const float kStiffness { 0.25f };
+
+// displacements smaller than this (in px) are ignored so the crowd settles.
+const float kMinMove { 0.05f };
+
+// below this many boxes, handing work to the pool costs more than it saves.
+const size_t kMinParallelBoxes { 512 };
+} // namespace
+
+Crowd::Crowd ()
+: fHash (kCellSize)
+{
+}
+
+Crowd::~Crowd ()
+{
+    setParallel (false);
+}
+
+void Crowd::setParallel (bool parallel)
+{
+    if (parallel && fPool == nullptr)
+        fPool = std::make_unique<juce::ThreadPool> (
+            std::max (1, juce::SystemStats::getNumCpus () - 1));
+    else if (!parallel && fPool != nullptr)
+    {
+        fPool->removeAllJobs (true, 1000);
+        fPool.reset ();
+    }
+}
+
+bool Crowd::step (BoxStore& store)
+{
+    const auto start { juce::Time::getHighResolutionTicks () };
+    const auto count { store.size () };
+
+    fCentres.resize (count);
+    fDelta.assign (count, {});
+    for (size_t slot { 0 }; slot < count; ++slot)
+    {
+        fCentres[slot] = { store.getX (slot) + store.getWidth (slot) / 2.f,
+                           store.getY (slot) + store.getHeight (slot) / 2.f };
+    }
+    fHash.rebuild (fCentres);
+
+    fStats       = {};
+    fStats.boxes = static_cast<int> (count);
+    if (fPool == nullptr || count < kMinParallelBoxes)
+        collide (store, 0, count, fStats);
+    else
+    {
+        // one chunk per pool thread, plus one that we do ourselves.
+        const auto chunks { static_cast<size_t> (fPool->getNumThreads ()) + 1 };
+        const auto chunkSize { (count + chunks - 1) / chunks };
+        std::vector<Stats> chunkStats (chunks);
+        std::atomic<size_t> pending { chunks - 1 };
+
+        for (size_t c { 1 }; c < chunks; ++c)
+        {
+            fPool->addJob (
+                [this, &store, &chunkStats, &pending, c, chunkSize, count]
+                {
+                    const auto begin { std::min (count, c * chunkSize) };
+                    collide (store, begin, std::min (count, begin + chunkSize),
+                             chunkStats[c]);
+                    --pending;
+                });
+        }
+        collide (store, 0, std::min (count, chunkSize), chunkStats[0]);
+
+        // the other chunks are about the same size, so they won't be long.
+        while (pending.load () > 0)
+            std::this_thread::yield ();
+
+        for (const auto& stats : chunkStats)
+        {
+            fStats.neighbourChecks += stats.neighbourChecks;
+            fStats.contacts += stats.contacts;
+        }
+    }
+
+    bool moved { false };
+    for (size_t slot { 0 }; slot < count; ++slot)
+    {
+        const auto delta { fDelta[slot] };
+        if (std::abs (delta.x) < kMinMove && std::abs (delta.y) < kMinMove)
+            continue;
+        store.setPosition (slot, store.getX (slot) + delta.x,
+                           store.getY (slot) + delta.y);
+        moved = true;
+    }
+
+    const auto ticks { juce::Time::getHighResolutionTicks () - start };
+    fStats.updateMs = juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+    return moved;
+}
+
+void Crowd::collide (const BoxStore& store, size_t begin, size_t end, Stats& stats)
+{
+    for (size_t i { begin }; i < end; ++i)
+    {
+        const auto centre { fCentres[i] };
+        const auto halfW { store.getWidth (i) / 2.f };
+        const auto halfH { store.getHeight (i) / 2.f };
+        juce::Point<float> delta;
+
+        fHash.forEachNear (
+            centre,
+            [&] (size_t j)
+            {
+                if (j == i)
+                    return;
+                ++stats.neighbourChecks;
+
+                const auto d { fCentres[j] - centre };
+                const auto reachX { halfW + store.getWidth (j) / 2.f };
+                const auto reachY { halfH + store.getHeight (j) / 2.f };
+                const auto overlapX { reachX - std::abs (d.x) };
+                const auto overlapY { reachY - std::abs (d.y) };
+                if (overlapX <= 0.f || overlapY <= 0.f)
+                    return;
+                ++stats.contacts;
+
+                // move away from the other box; boxes that are exactly on top of
+                // each other split by index so they don't both go the same way.
+                if (overlapX < overlapY)
+                {
+                    const auto away { d.x > 0.f || (d.x == 0.f && i < j) ? -1.f : 1.f };
+                    delta.x += away * overlapX * kStiffness;
+                }
+                else
+                {
+                    const auto away { d.y > 0.f || (d.y == 0.f && i < j) ? -1.f : 1.f };
+                    delta.y += away * overlapY * kStiffness;
+                }
+            });
+
+        fDelta[i] = delta;
+    }
+}
@@ -0,0 +1,92 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "boxStore.h"
+#include "spatialHash.h"
+
+/**
+ * @class Crowd
+ * @brief Makes the boxes in a `BoxStore` push each other apart.
+ *
+ * Each call to `step()` is one relaxation pass: every pair of overlapping boxes
+ * is pushed apart along whichever axis they overlap least, each box moving part
+ * of the way. Boxes that are still animating get pulled back toward their
+ * curves on the next frame, so they jostle past each other on the way to their
+ * targets; boxes that have stopped are shoved out of the way until nothing
+ * overlaps them.
+ *
+ * Neighbours are found with a `SpatialHash` rebuilt on every step, so the cost
+ * per step is roughly linear in the number of boxes rather than quadratic. Each
+ * box only writes its own displacement, so the narrow phase can be split
+ * across a thread pool with no locking.
+ */
+class Crowd
+{
+public:
+    struct Stats
+    {
+        int boxes { 0 };
+        /// candidate pairs that were tested for overlap.
+        juce::int64 neighbourChecks { 0 };
+        /// pairs that actually overlapped.
+        juce::int64 contacts { 0 };
+        double updateMs { 0.0 };
+    };
+
+    Crowd ();
+    ~Crowd ();
+
+    /**
+     * Split the overlap tests across a thread pool when there are enough boxes
+     * to make it worthwhile.
+     */
+    void setParallel (bool parallel);
+    bool isParallel () const { return fPool != nullptr; }
+
+    /**
+     * Push overlapping boxes apart, writing their new positions back into the
+     * store (which marks them dirty).
+     * @return true if any box moved.
+     */
+    bool step (BoxStore& store);
+
+    /**
+     * @return counts and timing from the most recent step.
+     */
+    const Stats& getStats () const { return fStats; }
+
+private:
+    /**
+     * Work out the displacement of boxes `begin` up to `end`.
+     */
+    void collide (const BoxStore& store, size_t begin, size_t end, Stats& stats);
+
+private:
+    SpatialHash fHash;
+    std::vector<juce::Point<float>> fCentres;
+    std::vector<juce::Point<float>> fDelta;
+
+    std::unique_ptr<juce::ThreadPool> fPool;
+    Stats fStats;
+};
@@ -21,18 +21,194 @@
 */
 
 #include "demoComponent.h"
+#include "animatedLayer.h"
 #include "animatorApp.h"
+#include "pipeline.h"
+
+namespace
+{
+const int kXpos { 0 };
+const int kYpos { 1 };
+
+// every box starts out at this saturation and fades to zero.
+const float kStartSaturation { 0.9f };
+
+// with the quality governor throttling fades, only every nth step of the
+// colour ramp is repainted.
+const int kThrottledFadeStep { 4 };
+
+// ...and when thinning breadcrumbs, only every nth point is recorded.
+const int kThinnedCrumbStep { 4 };
+
+// dead boxes kept around to be reused by the next ones spawned. The spares can
+// grow to twice this before the extras are destroyed, all in one go.
+const size_t kMaxSpareBoxes { 256 };
+
+// time constant (in ms) of the velocity hand-off applied after a box's curves
+// are rebuilt in flight.
+const float kHandoffTau { 80.f };
+
+// assumed when the platform doesn't report a display's refresh rate.
+const float kDefaultRefreshHz { 60.f };
+
+/**
+ * @return refresh rate (Hz) of the display that `component` is on.
+ */
+float getRefreshRate (const juce::Component& component)
+{
+    const auto& displays { juce::Desktop::getInstance ().getDisplays () };
+    const auto* display { displays.getDisplayForRect (component.getScreenBounds ()) };
+    if (display != nullptr && display->verticalFrequencyHz.has_value ())
+        return static_cast<float> (*display->verticalFrequencyHz);
+    return kDefaultRefreshHz;
+}
+
+float smoothStep (float t)
+{
+    t = juce::jlimit (0.f, 1.f, t);
+    return t * t * (3.f - 2.f * t);
+}
+
+/**
+ * How far along its curve is a value, 0..1 (springs will overshoot)?
+ */
+float progress (float value, float start, float end)
+{
+    const auto span { end - start };
+    if (std::abs (span) < 0.5f)
+        return 1.f;
+    return (value - start) / span;
+}
+
+CostProfiler::Category costCategory (DemoComponent::EffectType type)
+{
+    using Effect = DemoComponent::EffectType;
+    switch (type)
+    {
+        case Effect::kLinear: return CostProfiler::kLinear;
+        case Effect::kParametric: return CostProfiler::kParametric;
+        case Effect::kEaseIn: return CostProfiler::kEaseIn;
+        case Effect::kEaseOut: return CostProfiler::kEaseOut;
+        case Effect::kSpring: return CostProfiler::kSpring;
+        case Effect::kInOut: return CostProfiler::kInOutChain;
+    }
+    return CostProfiler::kLinear;
+}
+
+/**
+ * Does an effect of this type depend on the parameter `param`?
+ */
+bool usesParam (DemoComponent::EffectType type, const juce::Identifier& param)
+{
+    using Effect = DemoComponent::EffectType;
+    switch (type)
+    {
+        case Effect::kLinear: return param == ID::kDuration;
+
+        case Effect::kParametric: return param == ID::kDuration || param == ID::kCurve;
+
+        case Effect::kEaseIn:
+            return param == ID::kEaseInToleranceX || param == ID::kEaseInToleranceY ||
+                   param == ID::kEaseInSlewX || param == ID::kEaseInSlewY;
+
+        case Effect::kEaseOut:
+            return param == ID::kEaseOutToleranceX || param == ID::kEaseOutToleranceY ||
+                   param == ID::kEaseOutSlewX || param == ID::kEaseOutSlewY;
+
+        case Effect::kSpring:
+            return param == ID::kSpringToleranceX || param == ID::kSpringToleranceY ||
+                   param == ID::kSpringDampingX || param == ID::kSpringDampingY;
+
+        case Effect::kInOut: return false; // sequences can only be re-targeted.
+    }
+    return false;
+}
+
+/**
+ * The in/out effect as a static pipeline: ease in to the midpoint, ease out to
+ * the end, wait, then fade. The movement replays trajectories from `paths`.
+ */
+template <typename Params, typename Sink>
+auto makeInOutPipeline (juce::Point<float> start, juce::Point<float> end,
+                        const Params& params, TrajectoryCache& paths, Sink sink)
+{
+    const auto mid { (start + end) / 2.f };
+    const auto& inTol { params.easeInTolerance };
+    const auto& inSlew { params.easeInSlew };
+    const auto& outTol { params.easeOutTolerance };
+    const auto& outSlew { params.easeOutSlew };
+
+    auto moveIn { pipeline::move (paths.easeIn (start.x, mid.x, inTol.x, inSlew.x),
+                                  paths.easeIn (start.y, mid.y, inTol.y, inSlew.y)) };
+    auto moveOut { pipeline::move (paths.easeOut (mid.x, end.x, outTol.x, outSlew.x),
+                                   paths.easeOut (mid.y, end.y, outTol.y, outSlew.y)) };
+    const auto fadeMs { static_cast<float> (params.fadeDuration) };
+    auto fade { pipeline::value (step::Linear { kStartSaturation, 0.f, fadeMs }) };
+
+    return pipeline::make (
+        pipeline::chain (pipeline::sequence (moveIn, moveOut),
+                         pipeline::delay (static_cast<float> (params.fadeDelay)), fade),
+        sink);
+}
+} // namespace
+
+struct DemoComponent::InOutSink
+{
+    void operator() (float x, float y) const { owner->moveBox (boxId, { x, y }); }
+    void operator() (float saturation) const { owner->fadeBox (boxId, saturation); }
+
+    void linkDone (std::size_t link) const
+    {
+        // link 0 is the movement.
+        if (link == 0)
+            owner->endMovement (boxId);
+    }
+
+    void finished () const { owner->deleteBox (boxId); }
+
+    DemoComponent* owner;
+    int boxId;
+};
+
+struct DemoComponent::InOutPipelines
+: pipeline::Runner<decltype (makeInOutPipeline ({}, {},
+                                                std::declval<const SpawnParams&> (),
+                                                std::declval<TrajectoryCache&> (),
+                                                std::declval<InOutSink> ()))>
+{
+    using KeyedRunner::KeyedRunner;
+};
 
 class DemoBox : public juce::Component,
                 public juce::SettableTooltipClient
 {
 public:
-    DemoBox ()
+    explicit DemoBox (ColourRamp& ramp)
     : boxId { ++lastId }
+    {
+        randomise (ramp);
+    }
+
+    /**
+     * Bring a dead box back as a brand new one, with a new id, color and size,
+     * instead of destroying it and creating another component.
+     */
+    void recycle (ColourRamp& ramp)
+    {
+        boxId       = ++lastId;
+        fState      = {};
+        fMotion     = {};
+        fDrawBorder = true;
+        randomise (ramp);
+    }
+
+    void randomise (ColourRamp& ramp)
     {
         // juce::Random r;
         auto& r { juce::Random::getSystemRandom () };
-        fFill    = juce::Colour (r.nextFloat (), 0.9f, 0.9f, 0.9f);
+        fHueBucket = ColourRamp::getBucket (r.nextFloat ());
+        ramp.prepare (fHueBucket);
+        fFill    = ramp.getColour (fHueBucket, ColourRamp::getLevel (kStartSaturation));
         int size = r.nextInt ({ 50, 100 });
         setSize (size, size);
     }
@@ -40,39 +216,312 @@ public:
     void paint (juce::Graphics& g) override
     {
         g.fillAll (fFill);
-        const auto bounds = getLocalBounds ();
-        g.setColour (juce::Colours::black);
-        g.drawRect (bounds, 4);
+        if (fDrawBorder)
+        {
+            const auto bounds = getLocalBounds ();
+            g.setColour (juce::Colours::black);
+            g.drawRect (bounds, 4);
+        }
     }
 
-    float getSaturation () const { return fFill.getSaturation (); }
+    void setDrawBorder (bool shouldDraw)
+    {
+        if (shouldDraw != fDrawBorder)
+        {
+            fDrawBorder = shouldDraw;
+            repaint ();
+        }
+    }
 
-    void setSaturation (float newSaturation)
+    void setFill (juce::Colour newFill)
     {
-        fFill = fFill.withSaturation (newSaturation);
-        repaint ();
+        if (newFill != fFill)
+        {
+            fFill = newFill;
+            repaint ();
+        }
     }
 
     int getId () const { return boxId; }
 
     juce::String getTooltip () override { return juce::String (boxId); }
 
+    /**
+     * Start tracking a new movement from `start` to `end`. Called when the
+     * box is created and again whenever its curves are rebuilt.
+     */
+    void startMotion (juce::Point<float> start, juce::Point<float> end, double now)
+    {
+        fMotion.start      = start;
+        fMotion.end        = end;
+        fMotion.curvePos   = start;
+        fMotion.fromOffset = {};
+        fMotion.toOffset   = {};
+        fMotion.blendStart = { 1.f, 1.f };
+        fMotion.handoff    = {};
+
+        if (!fMotion.hasSample)
+            fMotion.position = start;
+        else
+        {
+            // we're replacing curves mid-flight; measure the velocity of the new
+            // ones on the next update and ease out the difference.
+            fMotion.handoffPending = true;
+            fMotion.handoffTime    = now;
+            fMotion.handoffOrigin  = start;
+        }
+    }
+
+    /**
+     * Where is this box going to end up (including any re-targeting)?
+     */
+    juce::Point<float> getTarget () const { return fMotion.end + fMotion.toOffset; }
+
+    /**
+     * Re-target the end of this box's movement without touching its curves. The
+     * change in end point is blended in over the remaining progress of the
+     * curves with a smoothstep, so the box doesn't jump or change speed
+     * abruptly.
+     */
+    void retargetEnd (juce::Point<float> newEnd)
+    {
+        auto& m { fMotion };
+        m.fromOffset = getOffset (m.curvePos);
+        m.toOffset   = newEnd - m.end;
+        const juce::Point<float> u { progress (m.curvePos.x, m.start.x, m.end.x),
+                                     progress (m.curvePos.y, m.start.y, m.end.y) };
+        m.blendStart = { juce::jlimit (0.f, 0.95f, u.x), juce::jlimit (0.f, 0.95f, u.y) };
+    }
+
+    /**
+     * Convert the raw value generated by the friz curves into the position that
+     * we display, applying any re-targeting offset and velocity hand-off.
+     */
+    juce::Point<float> resolvePosition (juce::Point<float> curvePos, double now)
+    {
+        fMotion.curvePos = curvePos;
+        auto pos { curvePos + getOffset (curvePos) };
+
+        if (fMotion.handoffPending && now > fMotion.handoffTime)
+        {
+            const auto dt { static_cast<float> (now - fMotion.handoffTime) };
+            auto& m { fMotion };
+            m.handoff        = m.velocity - (pos - m.handoffOrigin) / dt;
+            m.handoffPending = false;
+        }
+
+        if (!fMotion.handoff.isOrigin ())
+        {
+            // c(t) = dv * t * e^(-t/tau): zero at t=0 with a slope of dv, so the
+            // box keeps its old velocity and decays onto the new curves.
+            const auto t { static_cast<float> (now - fMotion.handoffTime) };
+            if (t > 6.f * kHandoffTau)
+                fMotion.handoff = {};
+            else
+                pos += fMotion.handoff * (t * std::exp (-t / kHandoffTau));
+        }
+
+        if (fMotion.hasSample && now > fMotion.lastTime)
+            fMotion.velocity =
+                (pos - fMotion.position) / static_cast<float> (now - fMotion.lastTime);
+        fMotion.position  = pos;
+        fMotion.lastTime  = now;
+        fMotion.hasSample = true;
+
+        return pos;
+    }
+
+    juce::Point<float> getPosition () const { return fMotion.position; }
+
+private:
+    juce::Point<float> getOffset (juce::Point<float> curvePos) const
+    {
+        const auto& m { fMotion };
+        return { blendAxis (curvePos.x, m.start.x, m.end.x, m.fromOffset.x, m.toOffset.x,
+                            m.blendStart.x),
+                 blendAxis (curvePos.y, m.start.y, m.end.y, m.fromOffset.y, m.toOffset.y,
+                            m.blendStart.y) };
+    }
+
+    static float blendAxis (float value, float start, float end, float from, float to,
+                            float blendStart)
+    {
+        if (blendStart >= 1.f)
+            return to;
+        const auto u { progress (value, start, end) };
+        return from + (to - from) * smoothStep ((u - blendStart) / (1.f - blendStart));
+    }
+
 public:
     juce::Colour fFill;
+    bool fDrawBorder { true };
+    int fHueBucket;
     inline static int lastId { 0 };
     int boxId;
+
+    /**
+     * Everything about a box's current life that starts over when it's
+     * recycled.
+     */
+    struct State
+    {
+        DemoComponent::EffectType type { DemoComponent::EffectType::kLinear };
+        // non-owning; this belongs to the animator, and is cleared when the
+        // movement completes.
+        friz::AnimationType* movement { nullptr };
+        int fadeDelay { 0 };
+        /// where this box is in the stage's box list.
+        size_t listIndex { 0 };
+        bool cancelled { false };
+        /// in the graveyard, waiting for the end of the frame.
+        bool dead { false };
+    };
+    State fState;
+
+private:
+    /**
+     * Where the box is heading, and how it's getting there.
+     */
+    struct Motion
+    {
+        juce::Point<float> start;
+        juce::Point<float> end;
+        juce::Point<float> curvePos;
+
+        // re-targeting without rebuilding the curves
+        juce::Point<float> fromOffset;
+        juce::Point<float> toOffset;
+        juce::Point<float> blendStart { 1.f, 1.f };
+
+        // velocity tracking (px/ms) and hand-off after rebuilding the curves
+        juce::Point<float> position;
+        juce::Point<float> velocity;
+        double lastTime { 0.0 };
+        /// has resolvePosition() run since the box was (re)started?
+        bool hasSample { false };
+        bool handoffPending { false };
+        double handoffTime { 0.0 };
+        juce::Point<float> handoffOrigin;
+        juce::Point<float> handoff;
+    };
+    Motion fMotion;
 };
 
 //==============================================================================
-DemoComponent::DemoComponent (juce::ValueTree params)
+bool DemoComponent::exportHeatmap (const juce::File& file)
+{
+    return fBreadcrumbs.exportPng (file);
+}
+
+void DemoComponent::setOccluder (juce::Rectangle<int> area)
+{
+    if (area.toFloat () != fOccluder)
+    {
+        fOccluder = area.toFloat ();
+        recull ();
+    }
+}
+
+size_t DemoComponent::getCulledCount () const
+{
+    return fStore.getCulledCount ();
+}
+
+size_t DemoComponent::getVisibleCount () const
+{
+    return fStore.size () - fStore.getCulledCount ();
+}
+
+void DemoComponent::recull ()
+{
+    fStore.markAll (BoxStore::kVisibility);
+    triggerAsyncUpdate ();
+}
+
+int DemoComponent::allocateClockId ()
+{
+    static int lastClockId { 0 };
+    return --lastClockId;
+}
+
+float DemoComponent::getFrameRate () const
+{
+    if (auto controller { fAnimator.getController () }; controller != nullptr)
+        return static_cast<float> (controller->getFrameRate ());
+    return 0.f;
+}
+
+void DemoComponent::gotoTime (float timeMs)
+{
+    tickAnimations (timeMs);
+    applyUpdates ();
+}
+
+void DemoComponent::tickAnimations (float timeMs)
+{
+    fVirtualTimeMs = timeMs;
+    fAnimator.gotoTime (timeMs);
+}
+
+double DemoComponent::getAnimationTime () const
+{
+    return fVirtualTimeMs >= 0.0 ? fVirtualTimeMs
+                                 : juce::Time::getMillisecondCounterHiRes ();
+}
+
+void DemoComponent::applyUpdates ()
+{
+    handleUpdateNowIfNeeded ();
+}
+
+void DemoComponent::paintBreadcrumbs (juce::Graphics& g)
+{
+    fBreadcrumbs.paintEntireComponent (g, false);
+}
+
+void DemoComponent::paintBoxes (juce::Graphics& g)
+{
+    for (auto& box : fBoxList)
+    {
+        if (!box->isVisible ())
+            continue;
+        juce::Graphics::ScopedSaveState state { g };
+        g.setOrigin (box->getBounds ().getPosition ());
+        box->paintEntireComponent (g, false);
+    }
+}
+
+DemoComponent::DemoComponent (juce::ValueTree params, friz::Animator* sharedAnimator)
 : fParams (params)
-, tooltips (this, 100)
+, tooltips (std::make_unique<juce::TooltipWindow> (this, 100))
+, fOwnAnimator (sharedAnimator == nullptr ? std::make_unique<friz::Animator> () : nullptr)
+, fAnimator (sharedAnimator == nullptr ? *fOwnAnimator : *sharedAnimator)
+, fGroupAnimator (sharedAnimator == nullptr ? nullptr
+                                             : std::make_unique<friz::Animator> ())
+, fBoxAnimator (fGroupAnimator == nullptr ? fAnimator : *fGroupAnimator)
+, fBoxClock (fAnimator, allocateClockId ())
+, fScripts (fAnimator, allocateClockId ())
+, fPipelines (std::make_unique<InOutPipelines> (fAnimator, allocateClockId ()))
+, fCrowdClock (fAnimator, allocateClockId ())
+, fFadeClock (fAnimator, allocateClockId ())
+, fScheduler (fAnimator, allocateClockId ())
+, fFades (static_cast<float> (static_cast<int> (params.getProperty (ID::kFadeDuration))))
+, fRamp (0.9f, 0.9f)
 {
 #if FRIZ_VBLANK_ENABLED
     // test the blank controller:
-    fAnimator.setController (std::make_unique<friz::DisplaySyncController> (this));
+    if (fOwnAnimator != nullptr)
+        fAnimator.setController (std::make_unique<friz::DisplaySyncController> (this));
 #endif
     
+    fBoxClock.onFrame = [this] (float deltaMs)
+    {
+        fBoxTimeMs += deltaMs;
+        fBoxAnimator.gotoTime (fBoxTimeMs);
+        if (fBoxAnimator.getNumAnimations () == 0)
+            fBoxClock.stop ();
+    };
+
     addAndMakeVisible (fBreadcrumbs);
     fBreadcrumbs.toBack ();
 
@@ -81,11 +530,57 @@ DemoComponent::DemoComponent (juce::ValueTree params)
     frameRate.setColour (juce::Label::textColourId, juce::Colours::black);
     frameRate.setAlwaysOnTop (true);
 
+    fCrowdClock.onFrame = [this] (float /*deltaMs*/)
+    {
+        const CostProfiler::Scope cost { fProfiler, CostProfiler::kCrowd, 0 };
+        if (fStore.size () == 0)
+            fCrowdClock.stop ();
+        else if (fCrowd.step (fStore))
+            triggerAsyncUpdate ();
+    };
+    syncCrowd ();
+
+    fFadeWheel.onDue = [this] (int boxId) { startFade (boxId); };
+    fFades.onValues = [this] (const int* ids, const float* values, size_t count)
+    {
+        const CostProfiler::Scope cost { fProfiler, CostProfiler::kFade, 0 };
+        applyFades (ids, values, count);
+    };
+    fFades.onFinished = [this] (const int* ids, size_t count)
+    {
+        // ...and when the fade is complete, delete the box from the demo
+        // component.
+        for (size_t i { 0 }; i < count; ++i)
+            deleteBox (ids[i]);
+    };
+    fFadeClock.onFrame = [this] (float deltaMs)
+    {
+        fFadeWheel.advance (deltaMs);
+        if (fFadeWheel.isEmpty ())
+            fFadeClock.stop ();
+    };
+
+    // the boxes' movement is friz's, on every frame; fading and breadcrumbs
+    // can fall behind a little when there's too much to do.
+    fFadeTask = fScheduler.add (FrameScheduler::Priority::kLow,
+                                [this] (float elapsedMs)
+                                {
+                                    fFades.advance (elapsedMs);
+                                    return fFades.size () > 0;
+                                });
+    fCrumbTask = fScheduler.add (FrameScheduler::Priority::kLow,
+                                 [this] (float /*elapsedMs*/)
+                                 { return sampleBreadcrumbs (); });
+
+    syncProfiler ();
+    fParams.addListener (this);
+
     startTimerHz (4);
 }
 
 DemoComponent::~DemoComponent ()
 {
+    fParams.removeListener (this);
     stopTimer ();
     clear ();
 }
@@ -101,29 +596,222 @@ void DemoComponent::resized ()
 {
     fBreadcrumbs.setBounds (getLocalBounds ());
     frameRate.setBounds (5, 5, 200, 18);
+
+    // any box that's still moving toward a spot that's no longer on stage gets
+    // re-targeted to the nearest point that is.
+    for (auto& box : fBoxList)
+    {
+        if (box->fState.movement == nullptr)
+            continue;
+
+        const auto target { box->getTarget () };
+        const auto maxX { static_cast<float> (
+            juce::jmax (0, getWidth () - box->getWidth ())) };
+        const auto maxY { static_cast<float> (
+            juce::jmax (0, getHeight () - box->getHeight ())) };
+        const juce::Point<float> onStage { juce::jlimit (0.f, maxX, target.x),
+                                           juce::jlimit (0.f, maxY, target.y) };
+        if (onStage != target)
+            box->retargetEnd (onStage);
+    }
+
+    recull ();
+}
+
+void DemoComponent::valueTreePropertyChanged (juce::ValueTree& /*tree*/,
+                                              const juce::Identifier& param)
+{
+    if (param == ID::kHeatmap)
+    {
+        syncBreadcrumbs (readParams ());
+        return;
+    }
+
+    if (param == ID::kInspector)
+    {
+        syncProfiler ();
+        return;
+    }
+
+    if (param == ID::kCrowd || param == ID::kCrowdParallel)
+    {
+        syncCrowd ();
+        return;
+    }
+
+    if (param == ID::kFadeDuration)
+    {
+        // restart any fades with the new duration from their current saturation.
+        int dur = fParams.getProperty (ID::kFadeDuration);
+        fFades.restart (static_cast<float> (dur));
+        return;
+    }
+
+    // cached trajectories for the old curve parameters won't be asked for again.
+    using Effect = EffectType;
+    if (usesParam (Effect::kEaseIn, param) || usesParam (Effect::kEaseOut, param))
+        fTrajectories.clear ();
+
+    const auto params { readParams () };
+    for (auto& box : fBoxList)
+    {
+        if (box->fState.movement != nullptr && usesParam (box->fState.type, param))
+            rebuildMovement (*box, params);
+    }
 }
 
 void DemoComponent::clear ()
 {
-    fAnimator.cancelAllAnimations (false);
-    fBoxList.clear ();
+    // boxes are all going at once, so there's no point in the completion
+    // callbacks of their animations deleting them one at a time.
+    fSweeping = true;
+    fCancelled.clear ();
+    fGraveyard.clear ();
+    fCrowdClock.stop ();
+    fFadeClock.stop ();
+    fFadeWheel.clear ();
+    fFades.clear ();
+    fScripts.clear ();
+    fPipelines->clear ();
+    fBoxClock.stop ();
+    // every box movement is on the box animator, and on a shared animator that
+    // one is ours alone, so this is one pass however many stages there are.
+    fBoxAnimator.cancelAllAnimations (false);
+    fSweeping = false;
+
+    cancelPendingUpdate ();
+    fStore.clear ();
+    destroyBoxes (fBoxList);
     fBreadcrumbs.clear ();
     repaint ();
 }
 
+bool DemoComponent::cancelBox (int boxId)
+{
+    const auto slot { fStore.find (boxId) };
+    if (slot == BoxStore::kNotFound)
+        return false;
+
+    auto* box { static_cast<DemoBox*> (fStore.getView (slot)) };
+    if (box->fState.cancelled || box->fState.dead)
+        return false;
+
+    box->fState.cancelled = true;
+    fCancelled.push_back (boxId);
+    // the runners stop stepping it right away and drop it at the end of their frame.
+    fScripts.cancel (boxId);
+    fPipelines->cancel (boxId);
+    fFades.cancel (boxId);
+    triggerAsyncUpdate ();
+    return true;
+}
+
+void DemoComponent::sweepCancelled ()
+{
+    if (fCancelled.empty ())
+        return;
+
+    fSweeping = true;
+    for (auto boxId : fCancelled)
+    {
+        // (a box can still finish on its own between being cancelled and here.)
+        const auto slot { fStore.find (boxId) };
+        if (slot == BoxStore::kNotFound)
+            continue;
+
+        // friz-driven boxes; a fade still waiting in the wheel finds no box
+        // when it comes due.
+        fBoxAnimator.cancelAnimation (boxId, false);
+        fBreadcrumbs.endTrail (boxId);
+        deleteBox (boxId);
+    }
+    fCancelled.clear ();
+    fSweeping = false;
+}
+
+void DemoComponent::buryDead ()
+{
+    if (fGraveyard.empty ())
+        return;
+
+    for (auto boxId : fGraveyard)
+    {
+        const auto slot { fStore.find (boxId) };
+        if (slot == BoxStore::kNotFound)
+            continue;
+        auto* box { static_cast<DemoBox*> (fStore.getView (slot)) };
+        fStore.remove (boxId);
+
+        // Hiding every dead box from this one callback lets the peer merge all
+        // of their areas into a single dirty region for the next paint.
+        box->setVisible (false);
+        if (AnimatedLayer::isActive (*box))
+            AnimatedLayer::end (*box);
+    }
+    fGraveyard.clear ();
+
+    // one pass to compact the box list; the dead go to the spares (and stay
+    // our children, just hidden).
+    size_t kept { 0 };
+    for (size_t i { 0 }; i < fBoxList.size (); ++i)
+    {
+        auto& box { fBoxList[i] };
+        if (box->fState.dead)
+        {
+            fSpareBoxes.push_back (std::move (box));
+            continue;
+        }
+
+        if (kept != i)
+            fBoxList[kept] = std::move (box);
+        fBoxList[kept]->fState.listIndex = kept;
+        ++kept;
+    }
+    fBoxList.resize (kept);
+
+    if (fSpareBoxes.size () >= 2 * kMaxSpareBoxes)
+    {
+        std::vector<std::unique_ptr<DemoBox>> extras;
+        std::move (fSpareBoxes.begin () + static_cast<std::ptrdiff_t> (kMaxSpareBoxes),
+                   fSpareBoxes.end (), std::back_inserter (extras));
+        fSpareBoxes.resize (kMaxSpareBoxes);
+        destroyBoxes (extras);
+    }
+}
+
+void DemoComponent::destroyBoxes (std::vector<std::unique_ptr<DemoBox>>& boxes)
+{
+    if (boxes.empty ())
+        return;
+
+    // a box deleted while it's still our child would search the whole child
+    // list to remove itself; instead, rebuild the list once without them.
+    std::vector<juce::Component*> doomed;
+    doomed.reserve (boxes.size ());
+    for (const auto& box : boxes)
+        doomed.push_back (box.get ());
+    std::sort (doomed.begin (), doomed.end ());
+
+    const auto children { getChildren () };
+    removeAllChildren ();
+    for (auto* child : children)
+    {
+        if (!std::binary_search (doomed.begin (), doomed.end (), child))
+            addChildComponent (child);
+    }
+    boxes.clear ();
+}
+
 DemoBox* DemoComponent::findBox (int boxId)
 {
-    using ptr = std::unique_ptr<DemoBox>;
-    auto it { std::find_if (begin (fBoxList), end (fBoxList),
-                            [boxId] (const ptr& box)
-                            { return (box->getId () == boxId); }) };
-    if (it == fBoxList.end ())
+    const auto slot { fStore.find (boxId) };
+    if (slot == BoxStore::kNotFound)
     {
         jassertfalse;
         return nullptr;
     }
 
-    return it->get ();
+    return static_cast<DemoBox*> (fStore.getView (slot));
 }
 
 void DemoComponent::mouseDown (const juce::MouseEvent& e)
@@ -134,30 +822,47 @@ void DemoComponent::mouseDown (const juce::MouseEvent& e)
     }
     else
     {
-        EffectType type = EffectType::kParametric;
+        createDemo (e.getPosition (), getEffectType (e.mods));
+    }
+}
 
-        if (e.mods.isShiftDown ())
-        {
-            if (e.mods.isAltDown ())
-            {
-                type = EffectType::kInOut;
-            }
-            else
-            {
-                type = EffectType::kEaseOut;
-            }
-        }
-        else if (e.mods.isAltDown ())
+void DemoComponent::mouseDrag (const juce::MouseEvent& e)
+{
+    if (e.mods.isPopupMenu () || !fParams.getProperty (ID::kSprayMode, false))
+        return;
+
+    // spray a burst of boxes around the mouse.
+    const int count  = fParams.getProperty (ID::kSprayCount, 10);
+    const auto spray = juce::Rectangle<int> (40, 40).withCentre (e.getPosition ());
+    createDemos (count, spray, getEffectType (e.mods));
+}
+
+DemoComponent::EffectType
+DemoComponent::getEffectType (const juce::ModifierKeys& mods) const
+{
+    EffectType type = EffectType::kParametric;
+
+    if (mods.isShiftDown ())
+    {
+        if (mods.isAltDown ())
         {
-            type = EffectType::kEaseIn;
+            type = EffectType::kInOut;
         }
-        else if (e.mods.isCommandDown ())
+        else
         {
-            type = EffectType::kSpring;
+            type = EffectType::kEaseOut;
         }
-
-        createDemo (e.getPosition (), type);
     }
+    else if (mods.isAltDown ())
+    {
+        type = EffectType::kEaseIn;
+    }
+    else if (mods.isCommandDown ())
+    {
+        type = EffectType::kSpring;
+    }
+
+    return type;
 }
 
 void DemoComponent::timerCallback ()
@@ -165,95 +870,322 @@ void DemoComponent::timerCallback ()
     updateRate ();
 }
 
+void DemoComponent::handleAsyncUpdate ()
+{
+    const auto start { juce::Time::getHighResolutionTicks () };
+    fProfiler.endFrame ();
+    drainSpawns ();
+    sweepCancelled ();
+    buryDead ();
+
+    const auto throttleFades { fQuality.isAtLeast (QualityGovernor::kThrottleFades) };
+    const auto stage { getLocalBounds ().toFloat () };
+    fStore.flush (
+        [this, throttleFades, &stage] (size_t slot, uint8_t flags)
+        {
+            auto* box { static_cast<DemoBox*> (fStore.getView (slot)) };
+
+            // a box that can't be seen keeps animating in the store, but its
+            // component is hidden and left alone until it comes back into view.
+            const juce::Rectangle<float> bounds { fStore.getX (slot), fStore.getY (slot),
+                                                  fStore.getWidth (slot),
+                                                  fStore.getHeight (slot) };
+            const auto culled { !stage.intersects (bounds) ||
+                                fOccluder.contains (bounds) };
+            const auto changed { fStore.setCulled (slot, culled) };
+            if (changed)
+                box->setVisible (!culled);
+            if (culled)
+                return;
+
+            // ...and when it does, it catches up on everything it skipped.
+            const auto catchUp { changed };
+            if (catchUp)
+                flags |= BoxStore::kPosition | BoxStore::kColor;
+
+            if ((flags & BoxStore::kPosition) != 0)
+            {
+                box->setTopLeftPosition (static_cast<int> (fStore.getX (slot)),
+                                         static_cast<int> (fStore.getY (slot)));
+            }
+            if ((flags & BoxStore::kColor) != 0)
+            {
+                // when fades are throttled, only some of the ramp's steps repaint.
+                const auto level { fStore.getLevel (slot) };
+                if (catchUp || !throttleFades || level % kThrottledFadeStep == 0)
+                    box->setFill (fRamp.getColour (fStore.getHueBucket (slot), level));
+            }
+        });
+
+    // putting the boxes where they belong has to happen every frame.
+    fScheduler.charge (juce::Time::highResolutionTicksToSeconds (
+                           juce::Time::getHighResolutionTicks () - start) *
+                       1000.0);
+
+    if (fRecorder != nullptr)
+        recordFrame ();
+}
+
+void DemoComponent::recordFrame ()
+{
+    const auto now { juce::Time::getMillisecondCounterHiRes () };
+    const auto frameMs { fLastFrameMs < 0.0 ? 0.0 : now - fLastFrameMs };
+    fLastFrameMs = now;
+
+    fRecorder->recordFrame ({ static_cast<float> (frameMs),
+                              static_cast<uint32_t> (fStore.size ()),
+                              static_cast<uint32_t> (fBoxList.size ()),
+                              static_cast<uint32_t> (fBreadcrumbs.getVertexCount ()) });
+}
+
+void DemoComponent::recordSample (float fps)
+{
+    const auto movements { std::count_if (fBoxList.begin (), fBoxList.end (),
+                                          [] (const auto& box)
+                                          { return box->fState.movement != nullptr; }) };
+
+    fRecorder->recordSample ({ fps, FlightRecorder::getResidentKb (),
+                               static_cast<uint32_t> (movements),
+                               static_cast<uint32_t> (fScripts.size ()),
+                               static_cast<uint32_t> (fPipelines->size ()),
+                               static_cast<uint32_t> (fFades.size ()),
+                               static_cast<uint32_t> (fFadeWheel.size ()),
+                               static_cast<uint32_t> (getSpawnQueueDepth ()),
+                               static_cast<uint32_t> (fQuality.getLevel ()) });
+}
+
 void DemoComponent::createDemo (juce::Point<int> startPoint, EffectType type)
 {
-    auto& r { juce::Random::getSystemRandom () };
+    const auto params { readParams () };
+    syncBreadcrumbs (params);
+    spawnBox (startPoint, type, params);
+}
+
+void DemoComponent::createDemos (int count, juce::Rectangle<int> region,
+                                 EffectType type)
+{
+    if (count <= 0)
+        return;
+
+    const auto params { readParams () };
+    syncBreadcrumbs (params);
 
-    bool enableCrumbs = fParams.getProperty (ID::kBreadcrumbs);
-    if (enableCrumbs != fBreadcrumbs.isEnabled ())
+    const auto extra { static_cast<size_t> (count) };
+    if (fBoxList.size () + extra > fBoxList.capacity ())
+        fBoxList.reserve (std::max (fBoxList.size () + extra, 2 * fBoxList.capacity ()));
+    fStore.grow (extra);
+
+    auto& r { juce::Random::getSystemRandom () };
+    for (int i { 0 }; i < count; ++i)
     {
-        fBreadcrumbs.enable (enableCrumbs);
-        fBreadcrumbs.clear ();
-        repaint ();
+        const auto x { region.getX () + r.nextInt (region.getWidth () + 1) };
+        const auto y { region.getY () + r.nextInt (region.getHeight () + 1) };
+        spawnBox ({ x, y }, type, params);
     }
+}
 
-    auto box { std::make_unique<DemoBox> () };
-    addAndMakeVisible (box.get ());
-    box->setBounds (startPoint.x, startPoint.y, box->getWidth (), box->getHeight ());
+bool DemoComponent::postSpawn (const SpawnRequest& request)
+{
+    if (!fSpawnQueue.push (request))
+        return false;
 
-    // set the animation parameters.
-    auto startX = static_cast<float> (startPoint.x);
-    auto endX   = static_cast<float> (r.nextInt ({ 0, getWidth () - box->getWidth () }));
-    auto startY = static_cast<float> (startPoint.y);
-    auto endY = static_cast<float> (r.nextInt ({ 0, getHeight () - box->getHeight () }));
+    // (only posts a message if there isn't one pending already.)
+    triggerAsyncUpdate ();
+    return true;
+}
 
-    std::unique_ptr<friz::AnimationType> movement =
-        std::make_unique<friz::Animation<2>> (box->getId ());
+void DemoComponent::drainSpawns ()
+{
+    if (fSpawnQueue.size () == 0)
+        return;
 
-    std::unique_ptr<friz::AnimatedValue> xCurve;
-    std::unique_ptr<friz::AnimatedValue> yCurve;
+    // one read of the parameters and one reservation for the whole batch.
+    const auto params { readParams () };
+    syncBreadcrumbs (params);
+    const auto expected { fSpawnQueue.size () };
+    if (fBoxList.size () + expected > fBoxList.capacity ())
+        fBoxList.reserve (fBoxList.size () + expected);
+    fStore.grow (expected);
 
-    int duration = fParams.getProperty (ID::kDuration, 500);
+    // stop at what we reserved for; anything pushed since then comes in the next
+    // batch.
+    fSpawnQueue.drain (
+        [this, &params] (const SpawnRequest& request)
+        {
+            if (request.durationMs < 0)
+                spawnBox (request.point, request.type, params);
+            else
+            {
+                auto custom { params };
+                custom.duration = request.durationMs;
+                spawnBox (request.point, request.type, custom);
+            }
+        },
+        expected);
+}
 
-    if (EffectType::kLinear == type)
+DemoComponent::SpawnParams DemoComponent::readParams () const
+{
+    auto pair = [this] (const juce::Identifier& x, const juce::Identifier& y,
+                        float defaultValue)
+    {
+        return juce::Point<float> (fParams.getProperty (x, defaultValue),
+                                   fParams.getProperty (y, defaultValue));
+    };
+
+    SpawnParams params;
+    params.breadcrumbs = fParams.getProperty (ID::kBreadcrumbs);
+    params.heatmap     = fParams.getProperty (ID::kHeatmap, false);
+    params.cacheLayers = fParams.getProperty (ID::kCacheBoxLayers, false);
+    params.crowd       = fParams.getProperty (ID::kCrowd, false);
+    params.inOutDriver = static_cast<InOutDriver> (
+        static_cast<int> (fParams.getProperty (ID::kInOutDriver, 0)));
+    params.duration    = fParams.getProperty (ID::kDuration, 500);
+    params.curve =
+        fParams.getProperty (ID::kCurve, friz::Parametric::CurveType::kLinear);
+    params.easeInTolerance  = pair (ID::kEaseInToleranceX, ID::kEaseInToleranceY, 0.1f);
+    params.easeInSlew       = pair (ID::kEaseInSlewX, ID::kEaseInSlewY, 1.1f);
+    params.easeOutTolerance = pair (ID::kEaseOutToleranceX, ID::kEaseOutToleranceY, 0.1f);
+    params.easeOutSlew      = pair (ID::kEaseOutSlewX, ID::kEaseOutSlewY, 1.1f);
+    params.springTolerance  = pair (ID::kSpringToleranceX, ID::kSpringToleranceY, 0.5f);
+    params.springDamping    = pair (ID::kSpringDampingX, ID::kSpringDampingY, 0.5f);
+    params.fadeDelay        = fParams.getProperty (ID::kFadeDelay);
+    params.fadeDuration     = fParams.getProperty (ID::kFadeDuration);
+    return params;
+}
+
+void DemoComponent::syncBreadcrumbs (const SpawnParams& params)
+{
+    if (params.breadcrumbs != fBreadcrumbs.isEnabled ())
     {
-        xCurve = std::make_unique<friz::Linear> (startX, endX, duration);
-        yCurve = std::make_unique<friz::Linear> (startY, endY, duration);
+        fBreadcrumbs.enable (params.breadcrumbs);
+        fBreadcrumbs.clear ();
+        repaint ();
     }
-    else if (EffectType::kParametric == type)
+    fBreadcrumbs.setMode (params.heatmap ? Breadcrumbs::Mode::kHeatmap
+                                         : Breadcrumbs::Mode::kPath);
+}
+
+void DemoComponent::syncCrowd ()
+{
+    fCrowd.setParallel (fParams.getProperty (ID::kCrowdParallel, false));
+    if (fParams.getProperty (ID::kCrowd, false) && fStore.size () > 0)
+        fCrowdClock.start ();
+    else
+        fCrowdClock.stop ();
+}
+
+void DemoComponent::syncProfiler ()
+{
+    const bool enabled { fParams.getProperty (ID::kInspector, false) };
+    fProfiler.setEnabled (enabled);
+
+    // the runners only time each item while someone's listening.
+    if (enabled)
     {
-        int curveType =
-            fParams.getProperty (ID::kCurve, friz::Parametric::CurveType::kLinear);
-        xCurve = std::make_unique<friz::Parametric> (startX, endX, duration, friz::Parametric::CurveType (curveType));
-        yCurve = std::make_unique<friz::Parametric> (startY, endY, duration, friz::Parametric::CurveType (curveType));
+        fScripts.onCost = [this] (int key, juce::int64 ticks)
+        { fProfiler.add (CostProfiler::kInOutScript, key, ticks); };
+        fPipelines->onCost = [this] (int key, juce::int64 ticks)
+        { fProfiler.add (CostProfiler::kInOutPipeline, key, ticks); };
     }
-    else if (EffectType::kEaseOut == type)
+    else
     {
-        float xTolerance = fParams.getProperty (ID::kEaseOutToleranceX, 0.1f);
-        float xSlew      = fParams.getProperty (ID::kEaseOutSlewX, 1.1f);
-        xCurve = std::make_unique<friz::EaseOut> (startX, endX, xTolerance, xSlew);
-
-        float yTolerance = fParams.getProperty (ID::kEaseOutToleranceY, 0.1f);
-        float ySlew      = fParams.getProperty (ID::kEaseOutSlewY, 1.1f);
-        yCurve = std::make_unique<friz::EaseOut> (startY, endY, yTolerance, ySlew);
+        fScripts.onCost    = nullptr;
+        fPipelines->onCost = nullptr;
     }
-    else if (EffectType::kEaseIn == type)
+}
+
+CostProfiler::Report DemoComponent::getCostReport () const
+{
+    auto report { fProfiler.getReport () };
+    if (!fProfiler.isEnabled ())
+        return report;
+
+    for (const auto& box : fBoxList)
     {
-        float xTolerance = fParams.getProperty (ID::kEaseInToleranceX, 0.1f);
-        float xSlew      = fParams.getProperty (ID::kEaseInSlewX, 1.1f);
-        xCurve = std::make_unique<friz::EaseIn> (startX, endX, xTolerance, xSlew);
+        if (box->fState.movement != nullptr && !box->fState.dead)
+            ++report.rows[costCategory (box->fState.type)].live;
+    }
+    auto& rows { report.rows };
+    rows[CostProfiler::kInOutScript].live   = static_cast<int> (fScripts.size ());
+    rows[CostProfiler::kInOutPipeline].live = static_cast<int> (fPipelines->size ());
+    rows[CostProfiler::kFade].live          = static_cast<int> (fFades.size ());
+    rows[CostProfiler::kCrowd].live         = fCrowdClock.isRunning () ? 1 : 0;
+    return report;
+}
 
-        float yTolerance = fParams.getProperty (ID::kEaseInToleranceY, 0.1f);
-        float ySlew      = fParams.getProperty (ID::kEaseInSlewY, 1.1f);
-        yCurve = std::make_unique<friz::EaseIn> (startY, endY, yTolerance, ySlew);
+void DemoComponent::spawnBox (juce::Point<int> startPoint, EffectType type,
+                              const SpawnParams& params)
+{
+    if (onSpawn)
+        onSpawn (startPoint, type);
+
+    // the clock stops itself whenever the stage empties out.
+    if (params.crowd)
+        fCrowdClock.start ();
+
+    auto& r { juce::Random::getSystemRandom () };
+
+    std::unique_ptr<DemoBox> box;
+    if (fSpareBoxes.empty ())
+    {
+        box = std::make_unique<DemoBox> (fRamp);
+        addAndMakeVisible (box.get ());
     }
-    else if (EffectType::kSpring == type)
+    else
     {
-        auto xAccel = std::abs (endX - startX) / 1000.f;
-        auto yAccel = std::abs (endY - startY) / 1000.f;
+        box = std::move (fSpareBoxes.back ());
+        fSpareBoxes.pop_back ();
+        box->recycle (fRamp);
+        box->toFront (false);
+        box->setVisible (true);
+    }
+    box->setBounds (startPoint.x, startPoint.y, box->getWidth (), box->getHeight ());
+    box->setDrawBorder (!fQuality.isAtLeast (QualityGovernor::kNoBorders));
+    if (fRecorder != nullptr)
+        fRecorder->recordSpawn (
+            { box->getId (), startPoint.x, startPoint.y, static_cast<uint32_t> (type) });
+
+    // set the animation parameters.
+    auto startX = static_cast<float> (startPoint.x);
+    auto endX   = static_cast<float> (r.nextInt ({ 0, getWidth () - box->getWidth () }));
+    auto startY = static_cast<float> (startPoint.y);
+    auto endY = static_cast<float> (r.nextInt ({ 0, getHeight () - box->getHeight () }));
 
-        float tolerance = fParams.getProperty (ID::kSpringToleranceX);
-        float damping   = fParams.getProperty (ID::kSpringDampingX);
-        xCurve =
-            std::make_unique<friz::Spring> (startX, endX, tolerance, xAccel, damping);
+    if (EffectType::kInOut == type && InOutDriver::kChain != params.inOutDriver)
+    {
+        const juce::Point<float> start { startX, startY };
+        const juce::Point<float> end { endX, endY };
+        if (params.cacheLayers)
+            AnimatedLayer::begin (*box);
 
-        tolerance = fParams.getProperty (ID::kSpringToleranceY);
-        damping   = fParams.getProperty (ID::kSpringDampingY);
-        yCurve =
-            std::make_unique<friz::Spring> (startY, endY, tolerance, yAccel, damping);
+        box->fState.type = type;
+        box->startMotion (start, end, getAnimationTime ());
+        fStore.add (box->getId (), box.get (), box->getBounds ().toFloat (),
+                    box->fHueBucket, kStartSaturation);
+        if (InOutDriver::kScript == params.inOutDriver)
+            fScripts.add (inOutScript (box->getId (), start, end, params), box->getId ());
+        else
+            fPipelines->add (makeInOutPipeline (start, end, params, fTrajectories,
+                                                InOutSink { this, box->getId () }),
+                             box->getId ());
+        box->fState.listIndex = fBoxList.size ();
+        fBoxList.push_back (std::move (box));
+        return;
     }
-    else if (EffectType::kInOut == type)
+
+    std::unique_ptr<friz::AnimationType> movement =
+        std::make_unique<friz::Animation<2>> (box->getId ());
+
+    if (EffectType::kInOut == type)
     {
         auto midX = (startX + endX) / 2;
         auto midY = (startY + endY) / 2;
 
-        float xTolerance = fParams.getProperty (ID::kEaseInToleranceX, 0.1f);
-        float xSlew      = fParams.getProperty (ID::kEaseInSlewX, 1.1f);
-        auto xCurve1 = std::make_unique<friz::EaseIn> (startX, midX, xTolerance, xSlew);
-
-        float yTolerance = fParams.getProperty (ID::kEaseInToleranceY, 0.1f);
-        float ySlew      = fParams.getProperty (ID::kEaseInSlewY, 1.1f);
-        auto yCurve1 = std::make_unique<friz::EaseIn> (startY, midY, yTolerance, ySlew);
+        auto xCurve1 = std::make_unique<friz::EaseIn> (
+            startX, midX, params.easeInTolerance.x, params.easeInSlew.x);
+        auto yCurve1 = std::make_unique<friz::EaseIn> (
+            startY, midY, params.easeInTolerance.y, params.easeInSlew.y);
 
         // maybe a cleaner way to write this?
         using fx2 = friz::Animation<2>::SourceList;
@@ -261,13 +1193,10 @@ void DemoComponent::createDemo (juce::Point<int> startPoint, EffectType type)
         auto effect1 = std::make_unique<friz::Animation<2>> (
             fx2 { std::move (xCurve1), std::move (yCurve1) });
 
-        xTolerance   = fParams.getProperty (ID::kEaseOutToleranceX, 0.1f);
-        xSlew        = fParams.getProperty (ID::kEaseOutSlewX, 1.1f);
-        auto xCurve2 = std::make_unique<friz::EaseOut> (midX, endX, xTolerance, xSlew);
-
-        yTolerance   = fParams.getProperty (ID::kEaseOutToleranceY, 0.1f);
-        ySlew        = fParams.getProperty (ID::kEaseOutSlewY, 1.1f);
-        auto yCurve2 = std::make_unique<friz::EaseOut> (midY, endY, yTolerance, ySlew);
+        auto xCurve2 = std::make_unique<friz::EaseOut> (
+            midX, endX, params.easeOutTolerance.x, params.easeOutSlew.x);
+        auto yCurve2 = std::make_unique<friz::EaseOut> (
+            midY, endY, params.easeOutTolerance.y, params.easeOutSlew.y);
         // compare to the above that uses the alias `fx2`
         auto effect2 = std::make_unique<friz::Animation<2>> (
             friz::Animation<2>::SourceList { std::move (xCurve2), std::move (yCurve2) });
@@ -278,80 +1207,279 @@ void DemoComponent::createDemo (juce::Point<int> startPoint, EffectType type)
 
         movement = std::move (sequence);
     }
-
-    const int kXpos { 0 };
-    const int kYpos { 1 };
-
-    if (EffectType::kInOut != type)
+    else
     {
-        movement->setValue (kXpos, std::move (xCurve));
-        movement->setValue (kYpos, std::move (yCurve));
+        auto curves { makeCurves (type, { startX, startY }, { endX, endY }, params) };
+        movement->setValue (kXpos, std::move (curves.first));
+        movement->setValue (kYpos, std::move (curves.second));
     }
 
+    // the box's contents don't change while it's moving, only its position.
+    if (params.cacheLayers)
+        AnimatedLayer::begin (*box);
+
+    box->fState.type     = type;
+    box->fState.movement = movement.get ();
+    box->startMotion ({ startX, startY }, { endX, endY }, getAnimationTime ());
+
     // On each update: move this box to the next position on the (x,y) curve.
     if (auto updater = dynamic_cast<friz::UpdateSource<2>*> (movement.get ()))
     {
         updater->onUpdate (
-            [this, kXpos, kYpos] (int id, const friz::Animation<2>::ValueList& val)
+            [this, category = costCategory (type)] (
+                int id, const friz::Animation<2>::ValueList& val)
             {
-                auto* box { findBox (id) };
-                if (box == nullptr)
-                {
-                    jassertfalse;
+                const CostProfiler::Scope cost { fProfiler, category, id };
+                moveBox (id, { val[kXpos], val[kYpos] });
+            });
+
+        updater->onCompletion (
+            [this] (int id, bool wasCanceled)
+            {
+                if (fSweeping)
                     return;
-                }
 
-                const auto x { static_cast<int> (val[kXpos]) };
-                const auto y { static_cast<int> (val[kYpos]) };
-                box->setTopLeftPosition (x, y);
-                fBreadcrumbs.addPoint (val[kXpos], val[kYpos]);
+                // the movement is done; it can't be re-targeted now.
+                endMovement (id);
+
+                // Second effect: After the movement is complete, wait, then fade
+                // the box to white and delete it. Rather than sitting in the
+                // animator as a delayed animation that's visited every frame,
+                // the fade waits in the timer wheel and isn't created until
+                // it's due.
+                if (auto* done = findBox (id); done != nullptr && !wasCanceled)
+                {
+                    fFadeWheel.schedule (id, done->fState.fadeDelay);
+                    fFadeClock.start ();
+                }
             });
     }
 
-    // Second effect: After the movement is complete, fade the box to white and then
-    // delete it.
-    float currentSat = box->getSaturation ();
+    box->fState.fadeDelay = params.fadeDelay;
+    fBoxAnimator.addAnimation (std::move (movement));
+    if (fGroupAnimator != nullptr)
+        fBoxClock.start ();
 
-    int delay = fParams.getProperty (ID::kFadeDelay);
-    int dur   = fParams.getProperty (ID::kFadeDuration);
-    auto fade = friz::makeAnimation<friz::Linear> (box->getId (), currentSat, 0.f, dur);
-    // don't start fading until `delay` frames have elapsed
-    fade->setDelay (delay);
+    fStore.add (box->getId (), box.get (), box->getBounds ().toFloat (),
+                box->fHueBucket, kStartSaturation);
+    box->fState.listIndex = fBoxList.size ();
+    fBoxList.push_back (std::move (box));
+}
 
-    fade->updateFn = [this] (int id, const friz::Animation<1>::ValueList& val)
+AnimScript DemoComponent::inOutScript (int boxId, juce::Point<float> start,
+                                       juce::Point<float> end, SpawnParams params)
+{
+    const auto mid { (start + end) / 2.f };
+    const auto move { [this, boxId] (float x, float y) { moveBox (boxId, { x, y }); } };
+
+    const auto& inTol { params.easeInTolerance };
+    const auto& inSlew { params.easeInSlew };
+    const auto& outTol { params.easeOutTolerance };
+    const auto& outSlew { params.easeOutSlew };
+
+    co_await script::tween (fTrajectories.easeIn (start.x, mid.x, inTol.x, inSlew.x),
+                            fTrajectories.easeIn (start.y, mid.y, inTol.y, inSlew.y),
+                            move);
+    co_await script::tween (fTrajectories.easeOut (mid.x, end.x, outTol.x, outSlew.x),
+                            fTrajectories.easeOut (mid.y, end.y, outTol.y, outSlew.y),
+                            move);
+    endMovement (boxId);
+
+    co_await script::delay (static_cast<float> (params.fadeDelay));
+    co_await script::tween (
+        step::Linear { kStartSaturation, 0.f, static_cast<float> (params.fadeDuration) },
+        [this, boxId] (float saturation) { fadeBox (boxId, saturation); });
+
+    deleteBox (boxId);
+}
+
+void DemoComponent::moveBox (int boxId, juce::Point<float> curvePos)
+{
+    const auto slot { fStore.find (boxId) };
+    if (slot == BoxStore::kNotFound)
     {
-        // every update, change the saturation value of the color.
-        if (auto* box = findBox (id); box != nullptr)
-            box->setSaturation (val[0]);
-        else
-            jassertfalse;
-    };
+        jassertfalse;
+        return;
+    }
+
+    auto* box { static_cast<DemoBox*> (fStore.getView (slot)) };
+    const auto pos { box->resolvePosition (curvePos, getAnimationTime ()) };
+    fStore.setPosition (slot, pos.x, pos.y);
+    if (fBreadcrumbs.isEnabled ())
+        fScheduler.wake (fCrumbTask);
+    triggerAsyncUpdate ();
+}
 
-    fade->completionFn = [this] (int id, bool /*wasCanceled*/)
+bool DemoComponent::sampleBreadcrumbs ()
+{
+    if (!fBreadcrumbs.isEnabled ())
+        return false;
+
+    bool moving { false };
+    for (size_t slot { 0 }; slot < fStore.size (); ++slot)
     {
-        // ...and when the fade animation is complete, delete the box from the
-        // demo component.
-        deleteBox (id);
-    };
+        if (fStore.getStage (slot) != BoxStore::Stage::kMoving)
+            continue;
+        fBreadcrumbs.addPoint (fStore.getId (slot), fStore.getX (slot),
+                               fStore.getY (slot));
+        moving = true;
+    }
+    return moving;
+}
 
-    // create a Chain to connect the animations together in order.
-    auto chain = std::make_unique<friz::Chain> (box->getId ());
-    chain->addAnimation (std::move (movement));
-    chain->addAnimation (std::move (fade));
+void DemoComponent::endMovement (int boxId)
+{
+    // (the trail is only sampled when there's time, so make sure it ends where
+    // the box stopped.)
+    if (const auto slot { fStore.find (boxId) }; slot != BoxStore::kNotFound)
+        fBreadcrumbs.addPoint (boxId, fStore.getX (slot), fStore.getY (slot));
+    fBreadcrumbs.endTrail (boxId);
 
-    fAnimator.addAnimation (std::move (chain));
+    // the box is about to start repainting as it fades, so stop caching it.
+    if (auto* box = findBox (boxId); box != nullptr)
+    {
+        fStore.setStage (fStore.find (boxId), BoxStore::Stage::kWaiting);
+        box->fState.movement = nullptr;
+        if (AnimatedLayer::isActive (*box))
+            AnimatedLayer::end (*box);
+    }
+}
 
-    fBoxList.push_back (std::move (box));
+void DemoComponent::fadeBox (int boxId, float saturation)
+{
+    // every update, change the saturation value of the color -- but we only
+    // need to repaint if that moves it to a different step on its color ramp.
+    if (const auto slot { fStore.find (boxId) }; slot != BoxStore::kNotFound)
+    {
+        fStore.setStage (slot, BoxStore::Stage::kFading);
+        if (fStore.setSaturation (slot, saturation))
+            triggerAsyncUpdate ();
+    }
+    else
+    {
+        jassertfalse;
+    }
+}
+
+void DemoComponent::startFade (int boxId)
+{
+    // the box may have been cancelled while it was waiting.
+    if (fStore.find (boxId) == BoxStore::kNotFound)
+        return;
+
+    // every fade is the same linear curve, so rather than an animation each,
+    // they all share one timeline.
+    fFades.add (boxId, kStartSaturation, 0.f);
+    fScheduler.wake (fFadeTask);
+}
+
+void DemoComponent::applyFades (const int* ids, const float* saturations, size_t count)
+{
+    bool changed { false };
+    for (size_t i { 0 }; i < count; ++i)
+    {
+        const auto slot { fStore.find (ids[i]) };
+        if (slot == BoxStore::kNotFound)
+            continue;
+        fStore.setStage (slot, BoxStore::Stage::kFading);
+        changed |= fStore.setSaturation (slot, saturations[i]);
+    }
+    if (changed)
+        triggerAsyncUpdate ();
+}
+
+DemoComponent::CurvePair DemoComponent::makeCurves (EffectType type,
+                                                    juce::Point<float> start,
+                                                    juce::Point<float> end,
+                                                    const SpawnParams& params)
+{
+    std::unique_ptr<friz::AnimatedValue> xCurve;
+    std::unique_ptr<friz::AnimatedValue> yCurve;
+
+    const int duration = params.duration;
+
+    if (EffectType::kLinear == type)
+    {
+        xCurve = std::make_unique<friz::Linear> (start.x, end.x, duration);
+        yCurve = std::make_unique<friz::Linear> (start.y, end.y, duration);
+    }
+    else if (EffectType::kParametric == type)
+    {
+        const auto curveType { friz::Parametric::CurveType (params.curve) };
+        xCurve = std::make_unique<friz::Parametric> (start.x, end.x, duration, curveType);
+        yCurve = std::make_unique<friz::Parametric> (start.y, end.y, duration, curveType);
+    }
+    else if (EffectType::kEaseOut == type)
+    {
+        xCurve = std::make_unique<friz::EaseOut> (
+            start.x, end.x, params.easeOutTolerance.x, params.easeOutSlew.x);
+        yCurve = std::make_unique<friz::EaseOut> (
+            start.y, end.y, params.easeOutTolerance.y, params.easeOutSlew.y);
+    }
+    else if (EffectType::kEaseIn == type)
+    {
+        xCurve = std::make_unique<friz::EaseIn> (
+            start.x, end.x, params.easeInTolerance.x, params.easeInSlew.x);
+        yCurve = std::make_unique<friz::EaseIn> (
+            start.y, end.y, params.easeInTolerance.y, params.easeInSlew.y);
+    }
+    else if (EffectType::kSpring == type)
+    {
+        auto xAccel = std::abs (end.x - start.x) / 1000.f;
+        auto yAccel = std::abs (end.y - start.y) / 1000.f;
+
+        xCurve = std::make_unique<friz::Spring> (start.x, end.x, params.springTolerance.x,
+                                                 xAccel, params.springDamping.x);
+        yCurve = std::make_unique<friz::Spring> (start.y, end.y, params.springTolerance.y,
+                                                 yAccel, params.springDamping.y);
+    }
+    else
+    {
+        jassertfalse;
+    }
+
+    return { std::move (xCurve), std::move (yCurve) };
+}
+
+bool DemoComponent::retarget (int boxId, juce::Point<float> newEnd)
+{
+    auto* box { findBox (boxId) };
+    if (box == nullptr || box->fState.movement == nullptr)
+        return false;
+
+    box->retargetEnd (newEnd);
+    return true;
+}
+
+bool DemoComponent::rebuildMovement (DemoBox& box, const SpawnParams& params)
+{
+    if (box.fState.movement == nullptr || EffectType::kInOut == box.fState.type)
+        return false;
+
+    // start the new curves where the box is right now, headed wherever it was
+    // last re-targeted to.
+    const auto from { box.getPosition () };
+    const auto to { box.getTarget () };
+
+    auto curves { makeCurves (box.fState.type, from, to, params) };
+    box.fState.movement->setValue (kXpos, std::move (curves.first));
+    box.fState.movement->setValue (kYpos, std::move (curves.second));
+    box.startMotion (from, to, getAnimationTime ());
+    return true;
 }
 
 bool DemoComponent::deleteBox (int boxId)
 {
     const auto box { findBox (boxId) };
-    if (box == nullptr)
+    if (box == nullptr || box->fState.dead)
         return false;
-    fBoxList.erase (std::remove_if (fBoxList.begin (), fBoxList.end (),
-                                    [&] (const std::unique_ptr<DemoBox>& b)
-                                    { return (b.get () == box); }));
+
+    // Completions tend to arrive in waves, so rather than tearing the box down
+    // here in the middle of the animator's tick, it's buried with the rest of
+    // this frame's dead at the start of the next flush.
+    box->fState.dead = true;
+    fGraveyard.push_back (boxId);
+    triggerAsyncUpdate ();
     return true;
 }
 
@@ -363,6 +1491,50 @@ void DemoComponent::updateRate ()
         jassertfalse;
         return;
     }
+    const auto fps { static_cast<float> (controller->getFrameRate ()) };
+    if (fRecorder != nullptr)
+        recordSample (fps);
+    fBreadcrumbs.adaptDetail (fps);
+    // (the window can be dragged to a display with a different refresh rate.)
+    fQuality.setTargetFps (getRefreshRate (*this));
+    if (fQuality.update (fps))
+        applyQuality ();
+
     auto rateTxt { juce::String (controller->getFrameRate (), 1) + " fps " };
+    if (fQuality.getLevel () != QualityGovernor::kFull)
+        rateTxt << "[" << QualityGovernor::getName (fQuality.getLevel ()) << "] ";
+    if (fScheduler.isStaggering ())
+    {
+        const auto& stats { fScheduler.getStats () };
+        rateTxt << "[staggered " << stats.lowRun << "/" << stats.lowBusy << "] ";
+    }
+    if (fCrowdClock.isRunning ())
+    {
+        const auto& stats { fCrowd.getStats () };
+        rateTxt << static_cast<int> (stats.neighbourChecks) << " checks "
+                << juce::String (stats.updateMs, 2) << " ms ";
+    }
+    if (const auto dropped { getDroppedSpawns () }; dropped > 0)
+        rateTxt << static_cast<int> (dropped) << " spawns dropped ";
+    if (const auto culled { getCulledCount () }; culled > 0)
+        rateTxt << static_cast<int> (culled) << "/" << static_cast<int> (fStore.size ())
+                << " culled ";
     frameRate.setText (rateTxt, juce::NotificationType::dontSendNotification);
 }
+
+void DemoComponent::applyQuality ()
+{
+    fBreadcrumbs.setThinning (
+        fQuality.isAtLeast (QualityGovernor::kThinCrumbs) ? kThinnedCrumbStep : 1);
+
+    const auto drawBorders { !fQuality.isAtLeast (QualityGovernor::kNoBorders) };
+    for (auto& box : fBoxList)
+        box->setDrawBorder (drawBorders);
+
+    // (throttled fades are handled as the box store is flushed.)
+
+    if (fQuality.isAtLeast (QualityGovernor::kNoTooltips))
+        tooltips.reset ();
+    else if (tooltips == nullptr)
+        tooltips = std::make_unique<juce::TooltipWindow> (this, 100);
+}
@@ -24,12 +24,25 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 
+#include "animScript.h"
+#include "boxStore.h"
 #include "breadcrumbs.h"
+#include "costProfiler.h"
+#include "flightRecorder.h"
+#include "frameScheduler.h"
+#include "crowd.h"
+#include "mpscQueue.h"
+#include "qualityGovernor.h"
+#include "sharedTimeline.h"
+#include "timerWheel.h"
+#include "trajectoryCache.h"
 
 class DemoBox;
 
 class DemoComponent : public juce::Component,
-                      public juce::Timer
+                      public juce::Timer,
+                      public juce::ValueTree::Listener,
+                      public juce::AsyncUpdater
 {
 public:
     enum class EffectType
@@ -41,38 +54,429 @@ public:
         kSpring,
         kInOut
     };
-    DemoComponent (juce::ValueTree params);
+
+    /**
+     * How `kInOut` boxes are animated.
+     */
+    enum class InOutDriver
+    {
+        kChain = 0, ///< a friz Sequence; the fade waits in the TimerWheel and
+                    ///< then runs on the SharedTimeline
+        kScript,    ///< an AnimScript coroutine
+        kPipeline   ///< a statically typed pipeline::Pipeline
+    };
+
+    /**
+     * @param params         parameter tree shared with the control panel
+     * @param sharedAnimator animator to run on, shared with other stages; if
+     *                       null, the stage creates and owns its own.
+     */
+    DemoComponent (juce::ValueTree params, friz::Animator* sharedAnimator = nullptr);
     ~DemoComponent ();
 
     void paint (juce::Graphics&) override;
     void resized () override;
 
     void mouseDown (const juce::MouseEvent& e) override;
+    void mouseDrag (const juce::MouseEvent& e) override;
 
     void timerCallback () override;
 
+    /**
+     * Called once after each animator tick that changed any boxes; pushes the
+     * new positions/colors from the box store out to the box components.
+     */
+    void handleAsyncUpdate () override;
+
+    void valueTreePropertyChanged (juce::ValueTree& tree,
+                                   const juce::Identifier& param) override;
+
     void createDemo (juce::Point<int> startPoint, EffectType type);
 
+    /**
+     * Spawn a burst of boxes at once. Parameters are read and storage is
+     * reserved once for the whole batch instead of once per box.
+     *
+     * @param count  number of boxes to create
+     * @param region each box starts at a random point inside this area
+     * @param type   effect to apply to every box in the batch.
+     */
+    void createDemos (int count, juce::Rectangle<int> region, EffectType type);
+
+    /**
+     * A request to spawn a box, posted from another thread.
+     */
+    struct SpawnRequest
+    {
+        juce::Point<int> point;
+        EffectType type;
+        /// if not negative, used instead of the duration parameter.
+        int durationMs { -1 };
+    };
+
+    /**
+     * Ask for a box to be spawned. Safe to call from any thread: the request
+     * goes into a preallocated lock-free ring, and everything posted is
+     * spawned in one batch at the start of the next frame on the message
+     * thread.
+     *
+     * @return false if the queue was full and the request was dropped.
+     */
+    bool postSpawn (const SpawnRequest& request);
+
+    /**
+     * @return requests posted but not yet spawned.
+     */
+    size_t getSpawnQueueDepth () const { return fSpawnQueue.size (); }
+
+    /**
+     * @return requests dropped because the queue was full.
+     */
+    juce::uint64 getDroppedSpawns () const { return fSpawnQueue.getDropCount (); }
+
+    /**
+     * @return boxes on the stage right now, moving or fading.
+     */
+    size_t getBoxCount () const { return fBoxList.size (); }
+
+    /**
+     * Remove every box at once. Completion callbacks from the animations that
+     * get cancelled are ignored rather than tearing boxes down one by one.
+     */
     void clear ();
 
+    /**
+     * Stop a single box's animations and remove it. Cheap to call for many
+     * boxes in a row: here the box is only marked, and every box marked during
+     * a frame is torn down together in one sweep at the end of it, without
+     * running its animations' completion callbacks.
+     *
+     * @return false if there's no such box or it's already been cancelled.
+     */
+    bool cancelBox (int boxId);
+
+    /**
+     * Send an in-flight box toward a new end point. The box keeps moving along
+     * its current curve; the difference between the old and new end points is
+     * blended in over the rest of the movement so that position and velocity
+     * both stay continuous. Doesn't allocate.
+     *
+     * @param boxId  id of the box to re-target
+     * @param newEnd new top-left position for the box to land on.
+     * @return       false if the box doesn't exist or has stopped moving.
+     */
+    bool retarget (int boxId, juce::Point<float> newEnd);
+
+    /**
+     * Write the breadcrumb density grid as a PNG heatmap the size of the stage.
+     * @return false if the file couldn't be written.
+     */
+    bool exportHeatmap (const juce::File& file);
+
+    /**
+     * Drive the stage from a virtual clock instead of the animator's own
+     * controller: advance every animation to `timeMs` and apply the results
+     * immediately, without waiting for the message loop.
+     */
+    void gotoTime (float timeMs);
+
+    /**
+     * The two halves of `gotoTime ()`, for the benchmark to measure apart:
+     * advance every animation to `timeMs` (their update callbacks write into
+     * the box store), then apply whatever changed to the boxes themselves.
+     */
+    void tickAnimations (float timeMs);
+    void applyUpdates ();
+
+    /**
+     * Paint just the breadcrumb trails, or just the visible boxes, into `g`
+     * the way they're painted as part of the stage.
+     */
+    void paintBreadcrumbs (juce::Graphics& g);
+    void paintBoxes (juce::Graphics& g);
+
+    /**
+     * Tell the stage which part of it is covered by an opaque component in
+     * front of it. Boxes entirely behind that area (or entirely off the stage)
+     * are culled: they keep animating, but aren't moved or repainted until
+     * they can be seen again.
+     *
+     * @param area covered area in our coordinates; empty if nothing covers us.
+     */
+    void setOccluder (juce::Rectangle<int> area);
+
+    /**
+     * @return number of boxes currently culled/visible.
+     */
+    size_t getCulledCount () const;
+    size_t getVisibleCount () const;
+
+    /**
+     * @return neighbour checks and update time of the last crowd step (when
+     *         boxes are pushing each other apart).
+     */
+    const Crowd::Stats& getCrowdStats () const { return fCrowd.getStats (); }
+
+    /**
+     * The stage's per-frame scheduler: the box fades and breadcrumb sampling
+     * are its low-priority tasks. Work that must happen every frame, here or
+     * elsewhere on the message thread, can `charge ()` its time against the
+     * budget they share.
+     */
+    FrameScheduler& getScheduler () { return fScheduler; }
+
+    /**
+     * @return the latest per-frame cost of each kind of animation, with counts
+     *         of how many of each are live right now. Empty unless the cost
+     *         inspector is turned on.
+     */
+    CostProfiler::Report getCostReport () const;
+
+    /**
+     * @return frame rate currently measured by our animator's controller.
+     */
+    float getFrameRate () const;
+
+    /**
+     * @return the animator driving this stage; its own, or the shared one.
+     */
+    friz::Animator& getAnimator () { return fAnimator; }
+
+    /**
+     * Ids for the clock animations that drive scripts and pipelines. Box ids
+     * count up from 1, so these can't collide with one -- or with another
+     * stage's clocks when stages share an animator.
+     */
+    static int allocateClockId ();
+
+    /**
+     * Called with the start point and type of every box as it's created.
+     */
+    std::function<void (juce::Point<int>, EffectType)> onSpawn;
+
+    /**
+     * Log frames, periodic samples of our queues and memory use, and spawns
+     * to `recorder` (nullptr to stop). The recorder must outlive us, or be
+     * detached first.
+     */
+    void setFlightRecorder (FlightRecorder* recorder) { fRecorder = recorder; }
+
 private:
+    using CurvePair = std::pair<std::unique_ptr<friz::AnimatedValue>,
+                                std::unique_ptr<friz::AnimatedValue>>;
+
+    /**
+     * A snapshot of everything in the parameter tree that we need to create
+     * boxes, so a batch of boxes only has to read the tree once. Pairs of x/y
+     * parameters are stored as points.
+     */
+    struct SpawnParams
+    {
+        bool breadcrumbs;
+        bool heatmap;
+        bool cacheLayers;
+        bool crowd;
+        InOutDriver inOutDriver;
+        int duration;
+        int curve;
+        juce::Point<float> easeInTolerance;
+        juce::Point<float> easeInSlew;
+        juce::Point<float> easeOutTolerance;
+        juce::Point<float> easeOutSlew;
+        juce::Point<float> springTolerance;
+        juce::Point<float> springDamping;
+        int fadeDelay;
+        int fadeDuration;
+    };
+
+    SpawnParams readParams () const;
+
+    /**
+     * Spawn every box posted with `postSpawn()` since the last call.
+     */
+    void drainSpawns ();
+
+    /**
+     * Make sure the breadcrumbs are in the state that the parameters ask for.
+     */
+    void syncBreadcrumbs (const SpawnParams& params);
+
+    /**
+     * Start/stop the crowd simulation to match the parameters.
+     */
+    void syncCrowd ();
+
+    /**
+     * Turn cost attribution on or off to match the parameters.
+     */
+    void syncProfiler ();
+
+    /**
+     * Low-priority task: add every moving box's position to its breadcrumb
+     * trail.
+     * @return true while there are boxes moving.
+     */
+    bool sampleBreadcrumbs ();
+
+    /**
+     * @return the time the animations are at, in ms: the real clock, or once
+     *         we're driven by `gotoTime ()`, the virtual time it was last given.
+     *         Velocities and re-target hand-offs are measured against this, so
+     *         an offline render comes out the same however fast the host is.
+     */
+    double getAnimationTime () const;
+
+    /**
+     * Add a frame record (from every update), or a sample record (from the
+     * timer) to the flight recorder.
+     */
+    void recordFrame ();
+    void recordSample (float fps);
+
+    EffectType getEffectType (const juce::ModifierKeys& mods) const;
+
+    /**
+     * Create a single box and its animations.
+     */
+    void spawnBox (juce::Point<int> startPoint, EffectType type,
+                   const SpawnParams& params);
+
+    /**
+     * Build the x/y curves for a single-stage effect.
+     * (`kInOut` is a sequence and isn't handled here.)
+     */
+    CurvePair makeCurves (EffectType type, juce::Point<float> start,
+                          juce::Point<float> end, const SpawnParams& params);
+
+    /**
+     * Replace the curves of a box that's still moving with new ones that start
+     * where the box is now, so that changed durations/curve parameters take
+     * effect immediately.
+     */
+    bool rebuildMovement (DemoBox& box, const SpawnParams& params);
+
+    /**
+     * The scripted version of the `kInOut` effect: ease in to the midpoint,
+     * ease out to the end, wait, fade, and delete the box.
+     */
+    AnimScript inOutScript (int boxId, juce::Point<float> start, juce::Point<float> end,
+                            SpawnParams params);
+
+    /**
+     * Per-frame work shared by the friz-driven and scripted effects.
+     */
+    void moveBox (int boxId, juce::Point<float> curvePos);
+    void endMovement (int boxId);
+    void fadeBox (int boxId, float saturation);
+
+    /**
+     * Start a friz-driven box's fade once its delay is up.
+     */
+    void startFade (int boxId);
+
+    /**
+     * Apply the values of a cohort of fades from `fFades`.
+     */
+    void applyFades (const int* ids, const float* saturations, size_t count);
+
+    /// receives values from the statically typed in/out pipelines.
+    struct InOutSink;
+    /// runner for the pipelines; its type is only spelled out in the .cpp
+    struct InOutPipelines;
+
     DemoBox* findBox (int boxId);
 
+    /**
+     * Re-check every box's visibility on the next flush.
+     */
+    void recull ();
+
+    /**
+     * Put a box in the graveyard; it's removed at the end of the frame.
+     */
     bool deleteBox (int boxId);
 
+    /**
+     * Remove every box in the graveyard at once: one compaction of
+     * `fBoxList`, keeping some of the dead components to recycle.
+     */
+    void buryDead ();
+
+    /**
+     * Destroy `boxes`, taking them out of our children in a single pass.
+     */
+    void destroyBoxes (std::vector<std::unique_ptr<DemoBox>>& boxes);
+
+    /**
+     * Tear down every box that's been cancelled since the last sweep.
+     */
+    void sweepCancelled ();
+
     void updateRate ();
 
+    /**
+     * Turn optional work on or off to match the quality governor's level.
+     */
+    void applyQuality ();
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DemoComponent)
 
     juce::ValueTree fParams;
-    juce::TooltipWindow tooltips;
+    /// removed entirely when the quality governor needs its timer back.
+    std::unique_ptr<juce::TooltipWindow> tooltips;
     juce::Label frameRate;
+    QualityGovernor fQuality;
+    CostProfiler fProfiler;
+    FlightRecorder* fRecorder { nullptr };
+    double fLastFrameMs { -1.0 };
+    /// last time passed to `tickAnimations ()`; negative if we're running live.
+    double fVirtualTimeMs { -1.0 };
 
-    friz::Animator fAnimator;
+    /// null when this stage is running on a shared animator.
+    std::unique_ptr<friz::Animator> fOwnAnimator;
+    friz::Animator& fAnimator;
+    /// on a shared animator, our boxes' movements are kept together on a private
+    /// one (stepped by `fBoxClock`), so they can all be dropped at once.
+    std::unique_ptr<friz::Animator> fGroupAnimator;
+    friz::Animator& fBoxAnimator;
+    FrameClock fBoxClock;
+    double fBoxTimeMs { 0.0 };
+    /// scripted effects, all ticked by a single clock animation on `fAnimator`.
+    ScriptRunner fScripts;
+    std::unique_ptr<InOutPipelines> fPipelines;
+    /// boxes pushing each other apart, stepped once per frame by its clock.
+    Crowd fCrowd;
+    FrameClock fCrowdClock;
+    /// friz-driven boxes wait out their fade delay here, not on the animator.
+    TimerWheel fFadeWheel;
+    FrameClock fFadeClock;
+    /// fades and breadcrumbs are low priority, staggered when frames are busy.
+    FrameScheduler fScheduler;
+    int fFadeTask;
+    int fCrumbTask;
+    /// ...and then all fade on one shared timeline.
+    SharedTimeline fFades;
     Breadcrumbs fBreadcrumbs;
 
     std::vector<std::unique_ptr<DemoBox>> fBoxList;
+    /// filled by `postSpawn()` on any thread, drained on the message thread.
+    MpscQueue<SpawnRequest, 4096> fSpawnQueue;
+
+    /// ids passed to `cancelBox()` since the last sweep.
+    std::vector<int> fCancelled;
+    /// ids of boxes that finished (or were cancelled) since the last flush.
+    std::vector<int> fGraveyard;
+    /// hidden components of dead boxes, ready to be reused.
+    std::vector<std::unique_ptr<DemoBox>> fSpareBoxes;
+    /// set while we're cancelling animations ourselves, to mute their callbacks.
+    bool fSweeping { false };
+    BoxStore fStore;
+    ColourRamp fRamp;
+    /// normalised curve shapes shared by scripted/pipelined boxes.
+    TrajectoryCache fTrajectories;
+    /// boxes entirely inside this area are hidden by whatever's in front of us.
+    juce::Rectangle<float> fOccluder;
 
     // int fNextEffectId { 0 };
 };
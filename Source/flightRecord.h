@@ -0,0 +1,113 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Layout of the flight recorder's ring file (see `FlightRecorder`), shared
+ * with the offline decoder in `Tools/flightDecode.cpp`. Plain C++, so the
+ * decoder builds without JUCE.
+ *
+ * The file is a `Header` followed by `capacity` fixed-size `Record` slots.
+ * Record number n (counting from 1) goes in slot (n - 1) % capacity. A slot's
+ * `sequence` is cleared before the rest of it is written and set last, so a
+ * record that was being written when the process died is recognisable: its
+ * sequence is 0, or doesn't belong in that slot. Values are in the byte
+ * order of the machine that wrote them.
+ */
+namespace flight
+{
+constexpr char kMagic[8] { 'F', 'R', 'I', 'Z', 'F', 'L', 'T', '1' };
+constexpr uint32_t kVersion { 1 };
+
+enum class Type : uint32_t
+{
+    kFrame = 1, ///< every stage update
+    kSample,    ///< a few times a second
+    kSpawn      ///< every box spawned
+};
+
+struct Frame
+{
+    /// time since the previous frame record.
+    float frameMs;
+    /// boxes in the store, and components in the stage's box list.
+    uint32_t liveBoxes;
+    uint32_t boxList;
+    /// vertices kept in the finished breadcrumb trails.
+    uint32_t crumbVertices;
+};
+
+struct Sample
+{
+    float fps;
+    uint32_t rssKb;
+    /// the queues of pending animation work.
+    uint32_t movements;
+    uint32_t scripts;
+    uint32_t pipelines;
+    uint32_t fades;
+    uint32_t waitingFades;
+    uint32_t spawnQueue;
+    uint32_t quality;
+};
+
+struct Spawn
+{
+    int32_t boxId;
+    int32_t x;
+    int32_t y;
+    uint32_t effect;
+};
+
+struct Record
+{
+    /// 0 if the slot is empty or was being written.
+    uint64_t sequence;
+    /// since `Header::startMs`.
+    uint64_t timeUs;
+    Type type;
+    union
+    {
+        Frame frame;
+        Sample sample;
+        Spawn spawn;
+    };
+};
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;
+    /// wall-clock time the recording started, in ms since 1970.
+    int64_t startMs;
+    /// records written so far.
+    uint64_t written;
+};
+
+static_assert (sizeof (Record) == 56, "the file format depends on this");
+static_assert (sizeof (Header) == 40, "the file format depends on this");
+} // namespace flight
@@ -0,0 +1,132 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "flightRecorder.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+#if JUCE_LINUX
+#include <unistd.h>
+#endif
+
+FlightRecorder::FlightRecorder (const juce::File& file, size_t capacity)
+: fCapacity (std::max<uint64_t> (1, capacity))
+{
+    if (file.existsAsFile ())
+        file.moveFileTo (file.getSiblingFile (file.getFileName () + ".prev"));
+
+    // start from a file of the full size, all zeros: every slot empty.
+    const auto bytes { sizeof (flight::Header) + fCapacity * sizeof (flight::Record) };
+    {
+        juce::FileOutputStream out { file };
+        if (!out.openedOk () || !out.setPosition (0) || out.truncate ().failed () ||
+            !out.writeRepeatedByte (0, bytes))
+            return;
+    }
+
+    fMap = std::make_unique<juce::MemoryMappedFile> (file,
+                                                     juce::MemoryMappedFile::readWrite);
+    if (fMap->getData () == nullptr || fMap->getSize () < bytes)
+    {
+        fMap.reset ();
+        return;
+    }
+
+    fHeader = static_cast<flight::Header*> (fMap->getData ());
+    std::memcpy (fHeader->magic, flight::kMagic, sizeof (flight::kMagic));
+    fHeader->version    = flight::kVersion;
+    fHeader->recordSize = sizeof (flight::Record);
+    fHeader->capacity   = fCapacity;
+    fHeader->startMs    = juce::Time::currentTimeMillis ();
+    fHeader->written    = 0;
+
+    fRecords = reinterpret_cast<flight::Record*> (fHeader + 1);
+    fStartMs = juce::Time::getMillisecondCounterHiRes ();
+}
+
+void FlightRecorder::recordFrame (const flight::Frame& frame)
+{
+    flight::Record record {};
+    record.type  = flight::Type::kFrame;
+    record.frame = frame;
+    write (record);
+}
+
+void FlightRecorder::recordSample (const flight::Sample& sample)
+{
+    flight::Record record {};
+    record.type   = flight::Type::kSample;
+    record.sample = sample;
+    write (record);
+}
+
+void FlightRecorder::recordSpawn (const flight::Spawn& spawn)
+{
+    flight::Record record {};
+    record.type  = flight::Type::kSpawn;
+    record.spawn = spawn;
+    write (record);
+}
+
+void FlightRecorder::write (flight::Record& record)
+{
+    if (fRecords == nullptr)
+        return;
+
+    const auto sequence { fHeader->written + 1 };
+    auto& slot { fRecords[(sequence - 1) % fCapacity] };
+
+    record.timeUs = static_cast<uint64_t> (
+        (juce::Time::getMillisecondCounterHiRes () - fStartMs) * 1000.0);
+
+    // the sequence goes in last, so a half-written record never looks whole. The
+    // mapping is read after a crash, so it's the compiler (not another core) that
+    // mustn't move the payload stores across the sequence stores; and the payload
+    // is copied around the slot's sequence, which never holds anything but 0 or
+    // the final value.
+    std::atomic_ref<uint64_t> (slot.sequence).store (0, std::memory_order_release);
+    std::atomic_signal_fence (std::memory_order_seq_cst);
+    constexpr auto payload { offsetof (flight::Record, timeUs) };
+    static_assert (offsetof (flight::Record, sequence) == 0);
+    std::memcpy (reinterpret_cast<char*> (&slot) + payload,
+                 reinterpret_cast<const char*> (&record) + payload,
+                 sizeof (flight::Record) - payload);
+    std::atomic_signal_fence (std::memory_order_seq_cst);
+    std::atomic_ref<uint64_t> (slot.sequence).store (sequence, std::memory_order_release);
+    std::atomic_ref<uint64_t> (fHeader->written)
+        .store (sequence, std::memory_order_release);
+}
+
+uint32_t FlightRecorder::getResidentKb ()
+{
+#if JUCE_LINUX
+    // the second field of statm is the resident set, in pages.
+    const auto statm { juce::File ("/proc/self/statm").loadFileAsString () };
+    const auto fields { juce::StringArray::fromTokens (statm, false) };
+    const auto pages { fields[1].getLargeIntValue () };
+    return static_cast<uint32_t> (pages * sysconf (_SC_PAGESIZE) / 1024);
+#else
+    return 0;
+#endif
+}
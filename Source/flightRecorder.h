@@ -0,0 +1,83 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+#include "flightRecord.h"
+
+/**
+ * @class FlightRecorder
+ * @brief Telemetry for soak tests, kept in a memory-mapped ring file.
+ *
+ * Each record is written straight into a shared mapping of a fixed-size file,
+ * so it's in the page cache the moment it's written: if the app stalls and is
+ * killed, or crashes, the kernel still writes out everything up to the last
+ * record. (A power cut loses whatever hadn't been flushed yet.) Once the ring
+ * is full the oldest records are overwritten, so the file always holds the
+ * most recent `capacity` records -- at the default size, around a quarter of
+ * an hour of a busy stage.
+ *
+ * A file left over from the previous run is kept next to the new one with
+ * `.prev` appended to its name. `Tools/flightDecode.cpp` turns either into
+ * CSV.
+ *
+ * Not thread-safe: record from the message thread.
+ */
+class FlightRecorder
+{
+public:
+    static constexpr size_t kDefaultCapacity { 65536 };
+
+    explicit FlightRecorder (const juce::File& file, size_t capacity = kDefaultCapacity);
+
+    /**
+     * @return false if the file couldn't be created or mapped; nothing is
+     *         recorded.
+     */
+    bool isOpen () const { return fRecords != nullptr; }
+
+    void recordFrame (const flight::Frame& frame);
+    void recordSample (const flight::Sample& sample);
+    void recordSpawn (const flight::Spawn& spawn);
+
+    /**
+     * @return resident set size of this process in KB (0 where we can't
+     *         tell).
+     */
+    static uint32_t getResidentKb ();
+
+private:
+    /**
+     * Stamp `record` and copy it into the next slot.
+     */
+    void write (flight::Record& record);
+
+private:
+    std::unique_ptr<juce::MemoryMappedFile> fMap;
+    flight::Header* fHeader { nullptr };
+    flight::Record* fRecords { nullptr };
+    const uint64_t fCapacity;
+    double fStartMs { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE (FlightRecorder)
+};
@@ -0,0 +1,81 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "frameClock.h"
+
+namespace
+{
+// each clock animation runs for one minute before being replaced.
+const float kClockSpanMs { 60000.f };
+} // namespace
+
+FrameClock::FrameClock (friz::Animator& animator, int clockId)
+: fAnimator { animator }
+, fClockId { clockId }
+{
+}
+
+FrameClock::~FrameClock ()
+{
+    stop ();
+}
+
+void FrameClock::start ()
+{
+    if (!fRunning)
+    {
+        fRunning = true;
+        launch ();
+    }
+}
+
+void FrameClock::stop ()
+{
+    if (fRunning)
+    {
+        fRunning = false;
+        fAnimator.cancelAnimation (fClockId, false);
+    }
+}
+
+void FrameClock::launch ()
+{
+    fLastValue = 0.f;
+    auto clock { friz::makeAnimation<friz::Linear> (fClockId, 0.f, kClockSpanMs,
+                                                    static_cast<int> (kClockSpanMs)) };
+
+    clock->updateFn = [this] (int /*id*/, const friz::Animation<1>::ValueList& val)
+    {
+        const auto delta { val[0] - fLastValue };
+        fLastValue = val[0];
+        if (fRunning && onFrame)
+            onFrame (delta);
+    };
+
+    clock->completionFn = [this] (int /*id*/, bool wasCanceled)
+    {
+        if (fRunning && !wasCanceled)
+            launch ();
+    };
+
+    fAnimator.addAnimation (std::move (clock));
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class FrameClock
+ * @brief Calls a function once per animator frame.
+ *
+ * The clock is just a long-running friz animation whose value is the number of
+ * milliseconds since it started, so anything driven by it runs in lockstep with
+ * the rest of the animations on the same `friz::Animator`. When the animation
+ * reaches the end of its span it's quietly replaced with a new one.
+ */
+class FrameClock
+{
+public:
+    /**
+     * @param animator animator to run on
+     * @param clockId  animation id to use; must not collide with any other
+     *                 animation on the same animator.
+     */
+    FrameClock (friz::Animator& animator, int clockId);
+    ~FrameClock ();
+
+    void start ();
+    void stop ();
+
+    bool isRunning () const { return fRunning; }
+
+    /**
+     * Called once per frame with the number of milliseconds since the
+     * previous frame.
+     */
+    std::function<void (float deltaMs)> onFrame;
+
+private:
+    void launch ();
+
+private:
+    friz::Animator& fAnimator;
+    const int fClockId;
+    bool fRunning { false };
+    float fLastValue { 0.f };
+};
@@ -0,0 +1,198 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "frameExporter.h"
+#include "MainComponent.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+namespace
+{
+const juce::String kRenderArg { "--render=" };
+const juce::String kScriptArg { "--render-script=" };
+const juce::String kFramesArg { "--render-frames=" };
+const juce::String kFpsArg { "--render-fps=" };
+const juce::String kThreadsArg { "--render-threads=" };
+
+juce::String valueOf (const juce::String& arg, const juce::String& prefix)
+{
+    return arg.fromFirstOccurrenceOf (prefix, false, false).unquoted ();
+}
+
+bool writePng (const juce::Image& image, const juce::File& file)
+{
+    file.deleteFile ();
+    juce::FileOutputStream stream { file };
+    if (!stream.openedOk ())
+        return false;
+
+    juce::PNGImageFormat png;
+    return png.writeImageToStream (image, stream);
+}
+
+double elapsedMs (juce::int64 startTicks)
+{
+    const auto ticks { juce::Time::getHighResolutionTicks () - startTicks };
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+}
+} // namespace
+
+FrameExporter::FrameExporter (const juce::String& commandLine)
+: fThreads { juce::SystemStats::getNumCpus () }
+{
+    const auto cwd { juce::File::getCurrentWorkingDirectory () };
+    for (const auto& arg : juce::StringArray::fromTokens (commandLine, true))
+    {
+        if (arg.startsWith (kRenderArg))
+            fOutputDir = cwd.getChildFile (valueOf (arg, kRenderArg));
+        else if (arg.startsWith (kScriptArg))
+            fScriptFile = cwd.getChildFile (valueOf (arg, kScriptArg));
+        else if (arg.startsWith (kFramesArg))
+            fFrames = std::max (1, valueOf (arg, kFramesArg).getIntValue ());
+        else if (arg.startsWith (kFpsArg))
+            fFramesPerSecond = std::max (1.0, valueOf (arg, kFpsArg).getDoubleValue ());
+        else if (arg.startsWith (kThreadsArg))
+            fThreads = std::max (1, valueOf (arg, kThreadsArg).getIntValue ());
+    }
+}
+
+bool FrameExporter::isRequested (const juce::String& commandLine)
+{
+    return commandLine.contains (kRenderArg);
+}
+
+int FrameExporter::run ()
+{
+    if (fOutputDir.createDirectory ().failed ())
+        return 1;
+
+    const auto spawns { fScriptFile.existsAsFile ()
+                            ? parseScript (fScriptFile.loadFileAsString ())
+                            : makeDefaultScript () };
+
+    juce::Random::getSystemRandom ().setSeed (kRandomSeed);
+
+    DemoComponent stage (MainComponent::createDefaultParams ());
+    stage.setSize (1000, 740);
+    // (frames take as long as they take; nothing gets staggered.)
+    stage.getScheduler ().setBudget (0.f);
+
+    juce::ThreadPool pool (fThreads);
+    std::atomic<int> failures { 0 };
+    // frames handed to the pool and not yet written; each job signals when it's
+    // done, so we can sleep until there's room instead of polling.
+    std::atomic<int> pending { 0 };
+    juce::WaitableEvent jobDone;
+    const auto maxPending { 2 * pool.getNumThreads () };
+
+    const auto frameMs { 1000.0 / fFramesPerSecond };
+    const auto start { juce::Time::getHighResolutionTicks () };
+    size_t next { 0 };
+    for (int frame { 0 }; frame < fFrames; ++frame)
+    {
+        const auto now { (frame + 1) * frameMs };
+        for (; next < spawns.size () && spawns[next].timeMs <= now; ++next)
+            stage.createDemo (spawns[next].point, spawns[next].type);
+
+        stage.gotoTime (static_cast<float> (now));
+        const auto image { stage.createComponentSnapshot (stage.getLocalBounds ()) };
+        const auto file { fOutputDir.getChildFile (
+            juce::String::formatted ("frame_%05d.png", frame)) };
+
+        // don't let rendered frames pile up faster than they can be encoded.
+        while (pending.load () >= maxPending)
+            jobDone.wait ();
+
+        ++pending;
+        pool.addJob (
+            [image, file, &failures, &pending, &jobDone]
+            {
+                if (!writePng (image, file))
+                    ++failures;
+                --pending;
+                jobDone.signal ();
+            });
+    }
+
+    while (pending.load () > 0)
+        jobDone.wait ();
+    const auto totalMs { elapsedMs (start) };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("frames", fFrames);
+    result->setProperty ("spawns", static_cast<int> (spawns.size ()));
+    result->setProperty ("threads", pool.getNumThreads ());
+    result->setProperty ("failures", failures.load ());
+    result->setProperty ("renderMs", totalMs);
+    result->setProperty ("realTimeFactor", (fFrames * frameMs) / std::max (totalMs, 1.0));
+    std::cout << juce::JSON::toString (juce::var (result.get ())) << std::endl;
+
+    return failures.load () == 0 ? 0 : 1;
+}
+
+std::vector<FrameExporter::Spawn> FrameExporter::parseScript (const juce::String& text)
+{
+    std::vector<Spawn> spawns;
+    for (const auto& line : juce::StringArray::fromLines (text))
+    {
+        const auto trimmed { line.trim () };
+        if (trimmed.isEmpty () || trimmed.startsWithChar ('#'))
+            continue;
+
+        const auto fields { juce::StringArray::fromTokens (trimmed, false) };
+        if (fields.size () < 4)
+            continue;
+
+        const auto lastType { static_cast<int> (DemoComponent::EffectType::kInOut) };
+        const auto type { juce::jlimit (0, lastType, fields[3].getIntValue ()) };
+        spawns.push_back ({ fields[0].getDoubleValue (),
+                            { fields[1].getIntValue (), fields[2].getIntValue () },
+                            static_cast<DemoComponent::EffectType> (type) });
+    }
+
+    std::stable_sort (spawns.begin (), spawns.end (), [] (const Spawn& a, const Spawn& b)
+                      { return a.timeMs < b.timeMs; });
+    return spawns;
+}
+
+juce::String FrameExporter::formatSpawn (const Spawn& spawn)
+{
+    return juce::String (spawn.timeMs, 1) + " " + juce::String (spawn.point.x) + " " +
+           juce::String (spawn.point.y) + " " +
+           juce::String (static_cast<int> (spawn.type));
+}
+
+std::vector<FrameExporter::Spawn> FrameExporter::makeDefaultScript ()
+{
+    // every effect type in turn, a quarter-second apart, across the stage.
+    std::vector<Spawn> spawns;
+    const auto typeCount { static_cast<int> (DemoComponent::EffectType::kInOut) + 1 };
+    for (int i { 0 }; i < 24; ++i)
+    {
+        spawns.push_back ({ i * 250.0,
+                            { 60 + (i % 6) * 150, 80 + (i / 6) * 150 },
+                            static_cast<DemoComponent::EffectType> (i % typeCount) });
+    }
+    return spawns;
+}
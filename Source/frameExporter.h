@@ -0,0 +1,88 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "demoComponent.h"
+
+#include <vector>
+
+/**
+ * @class FrameExporter
+ * @brief Renders the demo offline, one image file per frame.
+ *
+ * Launching the app with `--render=<directory>` plays a list of box spawns on a
+ * virtual clock instead of opening the main window: each frame, the stage's
+ * animations are advanced by exactly one frame's worth of time, the stage is
+ * rendered into an offscreen image, and the image is handed to a thread pool to
+ * be encoded as `frame_NNNNN.png`. Nothing depends on how busy the machine is,
+ * so the output is the same every time and usually much faster than real time.
+ *
+ * Other options:
+ * - `--render-script=<file>` spawns to play (see `parseScript ()`); without
+ *   one, a built-in sequence of every effect type is used.
+ *   `--record-spawns=<file>` writes this format from the live app.
+ * - `--render-frames=<n>` number of frames to render (default 300)
+ * - `--render-fps=<n>` frame rate of the virtual clock (default 60)
+ * - `--render-threads=<n>` encoder threads (default: one per CPU).
+ */
+class FrameExporter
+{
+public:
+    struct Spawn
+    {
+        double timeMs;
+        juce::Point<int> point;
+        DemoComponent::EffectType type;
+    };
+
+    explicit FrameExporter (const juce::String& commandLine);
+
+    /**
+     * @return true if the command line asks for an offline render.
+     */
+    static bool isRequested (const juce::String& commandLine);
+
+    /**
+     * Render every frame and wait for them all to be written.
+     * @return process exit code.
+     */
+    int run ();
+
+    /**
+     * A spawn script has one spawn per line: `<time ms> <x> <y> <effect>`,
+     * where `effect` is a `DemoComponent::EffectType` value. Blank lines and
+     * lines starting with `#` are ignored.
+     */
+    static std::vector<Spawn> parseScript (const juce::String& text);
+    static juce::String formatSpawn (const Spawn& spawn);
+
+private:
+    static std::vector<Spawn> makeDefaultScript ();
+
+private:
+    juce::File fOutputDir;
+    juce::File fScriptFile;
+    int fFrames { 300 };
+    double fFramesPerSecond { 60.0 };
+    int fThreads;
+};
@@ -0,0 +1,143 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "frameScheduler.h"
+
+namespace
+{
+/// weight of the newest run in each task's cost estimate.
+const double kCostSmoothing { 0.25 };
+
+double ticksToMs (juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+}
+} // namespace
+
+FrameScheduler::FrameScheduler (friz::Animator& animator, int clockId, float budgetMs)
+: fClock (animator, clockId)
+, fBudgetMs (budgetMs)
+{
+    fClock.onFrame = [this] (float deltaMs) { runFrame (deltaMs); };
+}
+
+int FrameScheduler::add (Priority priority, Task task)
+{
+    auto& tasks { priority == Priority::kHigh ? fHigh : fLow };
+    tasks.push_back ({ fNextId, std::move (task) });
+    return fNextId++;
+}
+
+void FrameScheduler::remove (int taskId)
+{
+    for (auto* tasks : { &fHigh, &fLow })
+    {
+        const auto matches { [taskId] (const Entry& e) { return e.id == taskId; } };
+        tasks->erase (std::remove_if (tasks->begin (), tasks->end (), matches),
+                      tasks->end ());
+    }
+    if (fNextLow >= fLow.size ())
+        fNextLow = 0;
+}
+
+void FrameScheduler::wake (int taskId)
+{
+    if (auto* entry { find (taskId) }; entry != nullptr && !entry->busy)
+    {
+        entry->busy      = true;
+        entry->pendingMs = 0.f;
+        fClock.start ();
+    }
+}
+
+FrameScheduler::Entry* FrameScheduler::find (int taskId)
+{
+    for (auto* tasks : { &fHigh, &fLow })
+    {
+        for (auto& entry : *tasks)
+        {
+            if (entry.id == taskId)
+                return &entry;
+        }
+    }
+    return nullptr;
+}
+
+double FrameScheduler::run (Entry& entry)
+{
+    const auto start { juce::Time::getHighResolutionTicks () };
+    entry.busy      = entry.task (entry.pendingMs);
+    entry.pendingMs = 0.f;
+    const auto ms { ticksToMs (juce::Time::getHighResolutionTicks () - start) };
+    entry.costMs += (ms - entry.costMs) * kCostSmoothing;
+    return ms;
+}
+
+void FrameScheduler::runFrame (float deltaMs)
+{
+    fStats         = {};
+    fStats.highMs  = fCharged;
+    fCharged       = 0.0;
+    bool anyBusy { false };
+
+    for (auto& entry : fHigh)
+    {
+        if (!entry.busy)
+            continue;
+        entry.pendingMs += deltaMs;
+        fStats.highMs += run (entry);
+        anyBusy |= entry.busy;
+    }
+
+    // every busy low-priority task gets this frame's time, whether or not it
+    // runs now.
+    for (auto& entry : fLow)
+    {
+        if (entry.busy)
+        {
+            entry.pendingMs += deltaMs;
+            ++fStats.lowBusy;
+        }
+    }
+
+    const auto count { fLow.size () };
+    size_t visited { 0 };
+    for (; visited < count; ++visited)
+    {
+        auto& entry { fLow[(fNextLow + visited) % count] };
+        if (!entry.busy)
+            continue;
+        const auto spent { fStats.highMs + fStats.lowMs };
+        if (fBudgetMs > 0.0 && fStats.lowRun > 0 && spent + entry.costMs > fBudgetMs)
+            break;
+        fStats.lowMs += run (entry);
+        ++fStats.lowRun;
+    }
+    // the next frame picks up where this one stopped.
+    if (count > 0)
+        fNextLow = (fNextLow + visited) % count;
+
+    for (const auto& entry : fLow)
+        anyBusy |= entry.busy;
+    if (!anyBusy)
+        fClock.stop ();
+}
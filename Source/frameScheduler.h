@@ -0,0 +1,142 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "frameClock.h"
+
+#include <vector>
+
+/**
+ * @class FrameScheduler
+ * @brief Runs per-frame tasks by priority, within a time budget.
+ *
+ * High-priority tasks run on every frame, however long they take. Whatever's
+ * left of the budget after them (and after any high-priority work done
+ * elsewhere and reported with `charge ()`) goes to the low-priority tasks,
+ * round-robin: each frame starts with the task after the last one that ran,
+ * and stops before the next task's estimated cost would overrun the budget.
+ * At least one low-priority task runs every frame, so under load they're
+ * staggered to a lower update rate rather than starved.
+ *
+ * A task is passed the time since it last ran, so one that skipped frames
+ * catches up in a single bigger step. It returns false when it has nothing
+ * left to do; once every task is idle the scheduler's clock stops until
+ * `wake ()` is called. Tasks may wake other tasks, but not add or remove them.
+ */
+class FrameScheduler
+{
+public:
+    enum class Priority
+    {
+        kHigh = 0,
+        kLow
+    };
+
+    /**
+     * @param elapsedMs time since this task last ran.
+     * @return true while the task has more work to do.
+     */
+    using Task = std::function<bool (float elapsedMs)>;
+
+    /// half of a 60 fps frame, leaving the rest for painting.
+    static constexpr float kDefaultBudgetMs { 8.f };
+
+    FrameScheduler (friz::Animator& animator, int clockId,
+                    float budgetMs = kDefaultBudgetMs);
+
+    /**
+     * @return an id for `wake ()` and `remove ()`. The task starts out idle.
+     */
+    int add (Priority priority, Task task);
+    void remove (int taskId);
+
+    /**
+     * Task `taskId` has work to do again.
+     */
+    void wake (int taskId);
+
+    /**
+     * Count `ms` of high-priority work done outside the scheduler against the
+     * budget of the next frame.
+     */
+    void charge (double ms) { fCharged += ms; }
+
+    /**
+     * @param budgetMs time per frame for everything; 0 lifts the budget, so
+     *                 every task runs on every frame (for repeatable offline
+     *                 runs).
+     */
+    void setBudget (float budgetMs) { fBudgetMs = budgetMs; }
+
+    struct Stats
+    {
+        /// high-priority time, including charges.
+        double highMs { 0.0 };
+        double lowMs { 0.0 };
+        int lowRun { 0 };
+        int lowBusy { 0 };
+    };
+
+    /**
+     * @return what happened on the most recent frame.
+     */
+    const Stats& getStats () const { return fStats; }
+
+    /**
+     * @return true if some low-priority task was skipped on the last frame.
+     */
+    bool isStaggering () const { return fStats.lowRun < fStats.lowBusy; }
+
+private:
+    struct Entry
+    {
+        int id;
+        Task task;
+        bool busy { false };
+        float pendingMs { 0.f };
+        /// smoothed duration of a run.
+        double costMs { 0.0 };
+    };
+
+    void runFrame (float deltaMs);
+
+    /**
+     * Run one task with the time it's accumulated.
+     * @return how long it took, in ms.
+     */
+    static double run (Entry& entry);
+
+    Entry* find (int taskId);
+
+private:
+    FrameClock fClock;
+    double fBudgetMs;
+
+    std::vector<Entry> fHigh;
+    std::vector<Entry> fLow;
+    size_t fNextLow { 0 };
+    int fNextId { 1 };
+
+    double fCharged { 0.0 };
+    Stats fStats;
+};
@@ -0,0 +1,103 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "inspectorPanel.h"
+
+namespace
+{
+const int kRowHeight { 16 };
+const int kMargin { 8 };
+} // namespace
+
+InspectorPanel::InspectorPanel (DemoComponent& stage)
+: fStage (stage)
+{
+    setInterceptsMouseClicks (false, false);
+    setSize (330, kMargin * 2 + kRowHeight *
+                                    (3 + CostProfiler::kNumCategories +
+                                     static_cast<int> (CostProfiler::kTopCount)));
+}
+
+InspectorPanel::~InspectorPanel ()
+{
+    stopTimer ();
+}
+
+void InspectorPanel::visibilityChanged ()
+{
+    if (isVisible ())
+        startTimerHz (4);
+    else
+        stopTimer ();
+}
+
+void InspectorPanel::timerCallback ()
+{
+    fReport = fStage.getCostReport ();
+    repaint ();
+}
+
+void InspectorPanel::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black.withAlpha (0.75f));
+    g.setColour (juce::Colours::white);
+    g.setFont (juce::Font (13.f));
+
+    auto area { getLocalBounds ().reduced (kMargin) };
+    auto row = [&area] { return area.removeFromTop (kRowHeight); };
+
+    auto columns = [&g] (juce::Rectangle<int> r, const juce::String& name,
+                         const juce::String& live, const juce::String& calls,
+                         const juce::String& avg, const juce::String& max)
+    {
+        g.drawText (name, r.removeFromLeft (120), juce::Justification::centredLeft);
+        g.drawText (live, r.removeFromLeft (45), juce::Justification::centredRight);
+        g.drawText (calls, r.removeFromLeft (50), juce::Justification::centredRight);
+        g.drawText (avg, r.removeFromLeft (50), juce::Justification::centredRight);
+        g.drawText (max, r.removeFromLeft (50), juce::Justification::centredRight);
+    };
+
+    columns (row (), "per frame", "live", "calls", "avg ms", "max ms");
+    for (int c { 0 }; c < CostProfiler::kNumCategories; ++c)
+    {
+        const auto& stats { fReport.rows[static_cast<size_t> (c)] };
+        columns (row (), CostProfiler::getName (static_cast<CostProfiler::Category> (c)),
+                 juce::String (stats.live), juce::String (stats.callsPerFrame, 1),
+                 juce::String (stats.averageMs, 3), juce::String (stats.maxMs, 3));
+    }
+
+    row ();
+    g.drawText ("most expensive (avg ms/frame)", row (),
+                juce::Justification::centredLeft);
+    for (const auto& hotspot : fReport.top)
+    {
+        // (shared animations, like the fade timeline, don't belong to a box.)
+        const auto name { hotspot.id > 0 ? "box " + juce::String (hotspot.id)
+                                         : juce::String ("(shared)") };
+        auto r { row () };
+        g.drawText (name, r.removeFromLeft (120), juce::Justification::centredLeft);
+        g.drawText (juce::String (hotspot.ms, 3), r.removeFromRight (50),
+                    juce::Justification::centredRight);
+        g.drawText (CostProfiler::getName (hotspot.category), r,
+                    juce::Justification::centredLeft);
+    }
+}
@@ -0,0 +1,55 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "demoComponent.h"
+
+/**
+ * @class InspectorPanel
+ * @brief Lists where the stage's per-frame animation time is going.
+ *
+ * A few times a second, takes the stage's latest cost report and shows, for
+ * each kind of animation, how many are live, how often they were called and
+ * what they cost per frame (average and worst), followed by the individual
+ * animations that cost the most.
+ */
+class InspectorPanel : public juce::Component,
+                       private juce::Timer
+{
+public:
+    explicit InspectorPanel (DemoComponent& stage);
+    ~InspectorPanel ();
+
+    void paint (juce::Graphics& g) override;
+
+    void visibilityChanged () override;
+
+private:
+    void timerCallback () override;
+
+private:
+    DemoComponent& fStage;
+    CostProfiler::Report fReport;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InspectorPanel)
+};
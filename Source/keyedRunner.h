@@ -0,0 +1,187 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+
+#include "frameClock.h"
+
+/**
+ * @class KeyedRunner
+ * @brief Owns a set of running items of one type, stored by value, and steps
+ *        them all from a single FrameClock -- so the whole set appears to the
+ *        `friz::Animator` as one animation.
+ *
+ * Items that finish are destroyed at the end of the frame; the clock is
+ * stopped whenever there's nothing left to run, so an idle runner doesn't keep
+ * its animator awake. An item added with a key can be cancelled by that key:
+ * cancelling is a set insert, the item stops being stepped at once and is
+ * destroyed, without finishing, in the same end-of-frame sweep.
+ *
+ * @tparam Item  what's being run; moved in, and kept in order.
+ * @tparam Steps how to run an `Item`:
+ *               `static void step (Item&, float ms)` and
+ *               `static bool isDone (const Item&)`.
+ */
+template <typename Item, typename Steps> class KeyedRunner
+{
+public:
+    static constexpr int kNoKey { 0 };
+
+    KeyedRunner (friz::Animator& animator, int clockId)
+    : fClock { animator, clockId }
+    {
+        fClock.onFrame = [this] (float deltaMs) { tick (deltaMs); };
+    }
+
+    void reserve (std::size_t count)
+    {
+        fItems.reserve (count);
+        fKeys.reserve (count);
+    }
+
+    /**
+     * Start running an item. Items that are already done are discarded.
+     * @param key if not `kNoKey`, can be passed to `cancel()` later.
+     */
+    void add (Item item, int key = kNoKey)
+    {
+        if (Steps::isDone (item))
+            return;
+
+        if (fTicking)
+        {
+            fPending.push_back (std::move (item));
+            fPendingKeys.push_back (key);
+        }
+        else
+        {
+            fItems.push_back (std::move (item));
+            fKeys.push_back (key);
+        }
+        fClock.start ();
+    }
+
+    /**
+     * Stop the item that was added with `key` without finishing it. Safe to
+     * call while stepping.
+     */
+    void cancel (int key)
+    {
+        jassert (key != kNoKey);
+        // the set is only cleared by a tick, and an idle runner doesn't tick.
+        if (size () > 0)
+            fCancelled.insert (key);
+    }
+
+    /**
+     * Destroy every item without finishing it. Must not be called while
+     * stepping.
+     */
+    void clear ()
+    {
+        jassert (!fTicking);
+        fItems.clear ();
+        fKeys.clear ();
+        fPending.clear ();
+        fPendingKeys.clear ();
+        fCancelled.clear ();
+        fClock.stop ();
+    }
+
+    std::size_t size () const { return fItems.size () + fPending.size (); }
+
+    /**
+     * If set, each item's step is timed and reported with its key.
+     */
+    std::function<void (int key, juce::int64 ticks)> onCost;
+
+    /**
+     * Advance every item by `ms` milliseconds. Normally called by our clock;
+     * public so that the benchmark can drive a runner directly.
+     */
+    void tick (float ms)
+    {
+        fTicking = true;
+        for (std::size_t i { 0 }; i < fItems.size (); ++i)
+        {
+            if (isCancelled (fKeys[i]))
+                continue;
+            if (onCost)
+            {
+                const auto start { juce::Time::getHighResolutionTicks () };
+                Steps::step (fItems[i], ms);
+                onCost (fKeys[i], juce::Time::getHighResolutionTicks () - start);
+            }
+            else
+                Steps::step (fItems[i], ms);
+        }
+        fTicking = false;
+
+        for (std::size_t i { 0 }; i < fPending.size (); ++i)
+        {
+            fItems.push_back (std::move (fPending[i]));
+            fKeys.push_back (fPendingKeys[i]);
+        }
+        fPending.clear ();
+        fPendingKeys.clear ();
+
+        // finished and cancelled items are destroyed together, keeping the
+        // running ones in order.
+        std::size_t kept { 0 };
+        for (std::size_t i { 0 }; i < fItems.size (); ++i)
+        {
+            if (Steps::isDone (fItems[i]) || isCancelled (fKeys[i]))
+                continue;
+            if (kept != i)
+            {
+                fItems[kept] = std::move (fItems[i]);
+                fKeys[kept]  = fKeys[i];
+            }
+            ++kept;
+        }
+        fItems.erase (fItems.begin () + static_cast<std::ptrdiff_t> (kept),
+                      fItems.end ());
+        fKeys.resize (kept);
+        fCancelled.clear ();
+
+        if (fItems.empty ())
+            fClock.stop ();
+    }
+
+private:
+    bool isCancelled (int key) const
+    {
+        return !fCancelled.empty () && key != kNoKey && fCancelled.count (key) != 0;
+    }
+
+private:
+    FrameClock fClock;
+    std::vector<Item> fItems;
+    std::vector<int> fKeys;
+    /// items added while we're ticking.
+    std::vector<Item> fPending;
+    std::vector<int> fPendingKeys;
+    std::unordered_set<int> fCancelled;
+    bool fTicking { false };
+};
@@ -0,0 +1,169 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include "keyedRunner.h"
+#include "subTest.h"
+
+namespace
+{
+/**
+ * Counts down a number of steps, logging its id on each one.
+ */
+struct Countdown
+{
+    int id;
+    int remaining;
+    std::vector<int>* log;
+    std::function<void ()> onStep;
+};
+
+struct CountdownSteps
+{
+    static void step (Countdown& item, float /*ms*/)
+    {
+        item.log->push_back (item.id);
+        --item.remaining;
+        if (item.onStep)
+            item.onStep ();
+    }
+
+    static bool isDone (const Countdown& item) { return item.remaining <= 0; }
+};
+
+using Runner = KeyedRunner<Countdown, CountdownSteps>;
+} // namespace
+
+class KeyedRunnerTest : public SubTest
+{
+public:
+    KeyedRunnerTest ()
+    : SubTest ("KeyedRunner", "frizDemo")
+    {
+    }
+
+    void Setup () override { fLog.clear (); }
+
+    void runTest () override
+    {
+        // the runners are ticked directly; the animator just hosts their clocks.
+        friz::Animator animator;
+
+        Test ("Finished items are dropped and the rest keep their order",
+              [&] ()
+              {
+                  Runner runner { animator, -1 };
+                  runner.add ({ 1, 1, &fLog, {} });
+                  runner.add ({ 2, 3, &fLog, {} });
+                  runner.add ({ 3, 2, &fLog, {} });
+                  runner.add ({ 4, 0, &fLog, {} });
+                  expectEquals (runner.size (), std::size_t { 3 });
+
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 1, 2, 3 });
+                  expectEquals (runner.size (), std::size_t { 2 });
+
+                  fLog.clear ();
+                  runner.tick (16.f);
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 2, 3, 2 });
+                  expectEquals (runner.size (), std::size_t { 0 });
+              });
+
+        Test ("Cancelled items stop at once",
+              [&] ()
+              {
+                  Runner runner { animator, -1 };
+                  for (int key { 1 }; key <= 4; ++key)
+                      runner.add ({ key, 5, &fLog, {} }, key);
+                  runner.tick (16.f);
+
+                  fLog.clear ();
+                  runner.cancel (2);
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 1, 3, 4 });
+                  expectEquals (runner.size (), std::size_t { 3 });
+              });
+
+        Test ("Cancelling from inside a step",
+              [&] ()
+              {
+                  Runner runner { animator, -1 };
+                  runner.add ({ 1, 5, &fLog, [&runner] () { runner.cancel (3); } }, 1);
+                  runner.add ({ 2, 5, &fLog, {} }, 2);
+                  runner.add ({ 3, 5, &fLog, {} }, 3);
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 1, 2 });
+                  expectEquals (runner.size (), std::size_t { 2 });
+              });
+
+        Test ("Items added during a tick start on the next one",
+              [&] ()
+              {
+                  Runner runner { animator, -1 };
+                  runner.add ({ 1, 1, &fLog,
+                                [&] () { runner.add ({ 2, 1, &fLog, {} }, 2); } },
+                              1);
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 1 });
+                  expectEquals (runner.size (), std::size_t { 1 });
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 1, 2 });
+                  expectEquals (runner.size (), std::size_t { 0 });
+              });
+
+        Test ("Cancelling a key that isn't running doesn't stick",
+              [&] ()
+              {
+                  Runner runner { animator, -1 };
+                  // an idle runner never ticks to forget it...
+                  runner.cancel (7);
+                  runner.add ({ 7, 1, &fLog, {} }, 7);
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 7 });
+
+                  // ...and a busy one forgets it at the end of the frame.
+                  fLog.clear ();
+                  runner.add ({ 1, 2, &fLog, {} }, 1);
+                  runner.cancel (9);
+                  runner.tick (16.f);
+                  runner.add ({ 9, 1, &fLog, {} }, 9);
+                  runner.tick (16.f);
+                  expect (fLog == std::vector<int> { 1, 1, 9 });
+              });
+
+        Test ("Clear drops everything",
+              [&] ()
+              {
+                  Runner runner { animator, -1 };
+                  runner.add ({ 1, 5, &fLog, {} }, 1);
+                  runner.add ({ 2, 5, &fLog, {} });
+                  runner.clear ();
+                  expectEquals (runner.size (), std::size_t { 0 });
+                  runner.tick (16.f);
+                  expect (fLog.empty ());
+              });
+    }
+
+private:
+    std::vector<int> fLog;
+};
+
+static KeyedRunnerTest keyedRunnerTest;
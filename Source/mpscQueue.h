@@ -0,0 +1,156 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class MpscQueue
+ * @brief A bounded, lock-free queue that any number of threads can push into
+ *        and one thread pops from.
+ *
+ * The storage is a ring of `kCapacity` cells allocated once up front, so
+ * pushing never allocates. Each cell carries a sequence number that tells
+ * producers whether it's free and the consumer whether it's been filled;
+ * producers claim cells by advancing the tail with a CAS, and publish them by
+ * bumping the cell's sequence. When the ring is full, `push()` fails instead of
+ * waiting, and the drop is counted.
+ *
+ * @tparam T         record type; copied in and out, so keep it small.
+ * @tparam kCapacity number of cells, a power of two.
+ */
+template <typename T, std::size_t kCapacity> class MpscQueue
+{
+public:
+    static_assert (kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0,
+                   "capacity must be a power of two");
+
+    MpscQueue ()
+    : fCells (std::make_unique<Cell[]> (kCapacity))
+    {
+        for (std::size_t i { 0 }; i < kCapacity; ++i)
+            fCells[i].sequence.store (i, std::memory_order_relaxed);
+    }
+
+    /**
+     * Safe to call from any thread.
+     * @return false (and count a drop) if the queue is full.
+     */
+    bool push (const T& value)
+    {
+        auto pos { fTail.load (std::memory_order_relaxed) };
+        Cell* cell;
+        for (;;)
+        {
+            cell = &fCells[pos & kMask];
+            const auto sequence { cell->sequence.load (std::memory_order_acquire) };
+            const auto diff { static_cast<std::intptr_t> (sequence) -
+                              static_cast<std::intptr_t> (pos) };
+            if (diff == 0)
+            {
+                if (fTail.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // the consumer hasn't freed this cell yet: we're full.
+                fDropped.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+                pos = fTail.load (std::memory_order_relaxed);
+        }
+
+        cell->value = value;
+        cell->sequence.store (pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop what had been pushed when the call started (up to `limit` values),
+     * calling `fn (value)` for each. Values pushed while we're draining wait for
+     * the next call, so busy producers can't keep the consumer here forever.
+     * Only ever call this from the one consumer thread.
+     * @return number of values popped.
+     */
+    template <typename Fn> std::size_t drain (Fn&& fn, std::size_t limit = kCapacity)
+    {
+        const auto tail { fTail.load (std::memory_order_acquire) };
+        const auto end { fHead + std::min (limit, tail - fHead) };
+        std::size_t count { 0 };
+        while (fHead != end)
+        {
+            auto& cell { fCells[fHead & kMask] };
+            const auto sequence { cell.sequence.load (std::memory_order_acquire) };
+            // claimed, but its producer hasn't finished writing it yet.
+            if (sequence != fHead + 1)
+                break;
+
+            const T value { cell.value };
+            cell.sequence.store (fHead + kCapacity, std::memory_order_release);
+            ++fHead;
+            fn (value);
+            ++count;
+        }
+        fHeadSnapshot.store (fHead, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @return roughly how many values are waiting (exact when nobody's pushing).
+     */
+    std::size_t size () const
+    {
+        const auto tail { fTail.load (std::memory_order_relaxed) };
+        const auto head { fHeadSnapshot.load (std::memory_order_relaxed) };
+        return tail > head ? tail - head : 0;
+    }
+
+    std::uint64_t getDropCount () const
+    {
+        return fDropped.load (std::memory_order_relaxed);
+    }
+
+    static constexpr std::size_t capacity () { return kCapacity; }
+
+private:
+    static constexpr std::size_t kMask { kCapacity - 1 };
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> fCells;
+
+    // producers and the consumer each get their own cache line.
+    alignas (64) std::atomic<std::size_t> fTail { 0 };
+    alignas (64) std::size_t fHead { 0 };
+    std::atomic<std::size_t> fHeadSnapshot { 0 };
+    std::atomic<std::uint64_t> fDropped { 0 };
+};
@@ -0,0 +1,167 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include "subTest.h"
+#include "mpscQueue.h"
+
+#include <algorithm>
+#include <thread>
+
+class MpscQueueTest : public SubTest
+{
+public:
+    MpscQueueTest ()
+    : SubTest ("MpscQueue", "frizDemo")
+    {
+    }
+
+    void runTest () override
+    {
+        Test ("Pushes into a full ring fail and are counted",
+              [this] ()
+              {
+                  MpscQueue<int, 8> queue;
+                  for (int i { 0 }; i < 8; ++i)
+                      expect (queue.push (i));
+                  expect (!queue.push (8));
+                  expect (!queue.push (9));
+                  expectEquals (queue.getDropCount (), std::uint64_t { 2 });
+
+                  std::vector<int> popped;
+                  expectEquals (queue.drain ([&] (int v) { popped.push_back (v); }),
+                                std::size_t { 8 });
+                  expect (popped == std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7 });
+                  expectEquals (queue.size (), std::size_t { 0 });
+
+                  // draining frees the cells again.
+                  expect (queue.push (10));
+                  expectEquals (queue.getDropCount (), std::uint64_t { 2 });
+              });
+
+        Test ("Values come out in order across wrap-around",
+              [this] ()
+              {
+                  MpscQueue<int, 4> queue;
+                  int next { 0 };
+                  int expected { 0 };
+                  bool inOrder { true };
+                  // batches of every size up to a full ring, so the head and tail
+                  // cross the end of the ring at every offset.
+                  for (int round { 0 }; round < 100; ++round)
+                  {
+                      const auto batch { 1 + round % 4 };
+                      for (int i { 0 }; i < batch; ++i)
+                          expect (queue.push (next++));
+                      queue.drain ([&] (int v) { inOrder = inOrder && v == expected++; });
+                  }
+                  expect (inOrder);
+                  expectEquals (expected, next);
+                  expectEquals (queue.getDropCount (), std::uint64_t { 0 });
+              });
+
+        Test ("A drain stops at what was queued when it started",
+              [this] ()
+              {
+                  MpscQueue<int, 8> queue;
+                  for (int i { 0 }; i < 3; ++i)
+                      expect (queue.push (i));
+
+                  // a producer that keeps up with the consumer can't keep it here.
+                  int next { 3 };
+                  std::vector<int> popped;
+                  expectEquals (queue.drain (
+                                    [&] (int v)
+                                    {
+                                        popped.push_back (v);
+                                        queue.push (next++);
+                                    }),
+                                std::size_t { 3 });
+                  expect (popped == std::vector<int> { 0, 1, 2 });
+                  expectEquals (queue.size (), std::size_t { 3 });
+
+                  // ...and a limit stops it sooner.
+                  popped.clear ();
+                  expectEquals (queue.drain ([&] (int v) { popped.push_back (v); }, 2),
+                                std::size_t { 2 });
+                  expect (popped == std::vector<int> { 3, 4 });
+                  expectEquals (queue.drain ([] (int) {}), std::size_t { 1 });
+              });
+
+        Test ("Values from many producers are drained exactly once",
+              [this] ()
+              {
+                  constexpr int kProducers { 4 };
+                  constexpr int kPerProducer { 50000 };
+                  // small enough that the producers keep filling it.
+                  MpscQueue<int, 64> queue;
+
+                  std::vector<std::uint64_t> failures (kProducers, 0);
+                  std::vector<std::thread> producers;
+                  for (int p { 0 }; p < kProducers; ++p)
+                  {
+                      producers.emplace_back (
+                          [&queue, &failures, p] ()
+                          {
+                              for (int i { 0 }; i < kPerProducer; ++i)
+                              {
+                                  while (!queue.push (p * kPerProducer + i))
+                                  {
+                                      ++failures[static_cast<size_t> (p)];
+                                      std::this_thread::yield ();
+                                  }
+                              }
+                          });
+                  }
+
+                  std::vector<int> seen (kProducers * kPerProducer, 0);
+                  std::vector<int> last (kProducers, -1);
+                  bool fifo { true };
+                  int received { 0 };
+                  while (received < kProducers * kPerProducer)
+                  {
+                      received += static_cast<int> (queue.drain (
+                          [&] (int v)
+                          {
+                              ++seen[static_cast<size_t> (v)];
+                              // each producer's own values stay in order.
+                              const auto producer { v / kPerProducer };
+                              auto& previous { last[static_cast<size_t> (producer)] };
+                              fifo     = fifo && v > previous;
+                              previous = v;
+                          }));
+                  }
+                  for (auto& t : producers)
+                      t.join ();
+
+                  expect (std::all_of (seen.begin (), seen.end (),
+                                       [] (int count) { return count == 1; }));
+                  expect (fifo);
+                  expectEquals (queue.drain ([] (int) {}), std::size_t { 0 });
+
+                  std::uint64_t failed { 0 };
+                  for (auto f : failures)
+                      failed += f;
+                  expectEquals (queue.getDropCount (), failed);
+              });
+    }
+};
+
+static MpscQueueTest mpscQueueTest;
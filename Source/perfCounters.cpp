@@ -0,0 +1,178 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "perfCounters.h"
+
+#if JUCE_LINUX
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if JUCE_LINUX
+struct EventConfig
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+// same order as PerfCounters::Event.
+const EventConfig kEvents[] {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+int openEvent (const EventConfig& event, int groupFd)
+{
+    perf_event_attr attr;
+    std::memset (&attr, 0, sizeof (attr));
+    attr.size           = sizeof (attr);
+    attr.type           = event.type;
+    attr.config         = event.config;
+    attr.disabled       = groupFd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // this thread, any CPU.
+    return static_cast<int> (syscall (SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+} // namespace
+
+const char* PerfCounters::getName (Event event)
+{
+    switch (event)
+    {
+        case kCycles: return "cycles";
+        case kInstructions: return "instructions";
+        case kL1dMisses: return "l1dMisses";
+        case kLlcMisses: return "llcMisses";
+        case kBranchMisses: return "branchMisses";
+        case kNumEvents: break;
+    }
+    return "";
+}
+
+PerfCounters::Counts& PerfCounters::Counts::operator+= (const Counts& rhs)
+{
+    for (size_t i { 0 }; i < values.size (); ++i)
+        values[i] += rhs.values[i];
+    scaled = scaled || rhs.scaled;
+    valid  = valid && rhs.valid;
+    return *this;
+}
+
+PerfCounters::PerfCounters ()
+{
+    fFds.fill (-1);
+#if JUCE_LINUX
+    int lastErrno { 0 };
+    for (size_t i { 0 }; i < fFds.size (); ++i)
+    {
+        fFds[i] = openEvent (kEvents[i], fLeader);
+        if (fFds[i] < 0)
+            lastErrno = errno;
+        else if (fLeader < 0)
+            fLeader = fFds[i];
+    }
+
+    if (fLeader < 0)
+    {
+        fError = "perf_event_open: " + juce::String (std::strerror (lastErrno));
+        if (lastErrno == EACCES || lastErrno == EPERM)
+            fError << " (see /proc/sys/kernel/perf_event_paranoid)";
+    }
+#else
+    fError = "hardware counters are only read on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters ()
+{
+#if JUCE_LINUX
+    for (auto fd : fFds)
+    {
+        if (fd >= 0)
+            close (fd);
+    }
+#endif
+}
+
+void PerfCounters::start ()
+{
+#if JUCE_LINUX
+    if (fLeader < 0)
+        return;
+    ioctl (fLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl (fLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounters::Counts PerfCounters::stop ()
+{
+    Counts counts;
+#if JUCE_LINUX
+    if (fLeader < 0)
+        return counts;
+    ioctl (fLeader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    for (size_t i { 0 }; i < fFds.size (); ++i)
+    {
+        // matches the attr.read_format we asked for.
+        struct
+        {
+            uint64_t value;
+            uint64_t timeEnabled;
+            uint64_t timeRunning;
+        } reading {};
+        if (fFds[i] < 0 || read (fFds[i], &reading, sizeof (reading)) != sizeof (reading))
+            continue;
+
+        if (reading.timeRunning == 0)
+        {
+            // enabled but never scheduled onto the PMU: there's nothing to scale.
+            if (reading.timeEnabled > 0)
+                counts.valid = false;
+            continue;
+        }
+
+        auto value { static_cast<double> (reading.value) };
+        if (reading.timeRunning < reading.timeEnabled)
+        {
+            value *= static_cast<double> (reading.timeEnabled) /
+                     static_cast<double> (reading.timeRunning);
+            counts.scaled = true;
+        }
+        counts.values[i] = static_cast<juce::int64> (value);
+    }
+#endif
+    return counts;
+}
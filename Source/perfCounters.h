@@ -0,0 +1,99 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+#include <array>
+
+/**
+ * @class PerfCounters
+ * @brief Hardware performance counters around a stretch of code (Linux only).
+ *
+ * Opens CPU cycles, instructions retired, L1 data cache read misses, last
+ * level cache misses and branch misses for the calling thread with
+ * `perf_event_open`, as one group so they're all counting over the same
+ * instructions. `start ()`/`stop ()` bracket the code to measure; `stop ()`
+ * returns the counts since the matching `start ()`, scaled up by the kernel's
+ * enabled/running times if the counters were multiplexed.
+ *
+ * Counters that the CPU or kernel doesn't offer are left out. If none can be
+ * opened (another OS, a VM without a PMU, or `kernel.perf_event_paranoid`
+ * forbidding it), `isAvailable ()` is false, `getError ()` says why, and
+ * `start ()`/`stop ()` do nothing, so the caller can still report its
+ * wall-clock times.
+ */
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        kCycles = 0,
+        kInstructions,
+        kL1dMisses,
+        kLlcMisses,
+        kBranchMisses,
+        kNumEvents
+    };
+
+    /**
+     * @return the name of an event as used in the benchmark's JSON.
+     */
+    static const char* getName (Event event);
+
+    struct Counts
+    {
+        Counts& operator+= (const Counts& rhs);
+
+        std::array<juce::int64, kNumEvents> values {};
+        /// the kernel had to share the PMU, so the values are scaled estimates.
+        bool scaled { false };
+        /// false if a counter was enabled but never actually counted.
+        bool valid { true };
+    };
+
+    PerfCounters ();
+    ~PerfCounters ();
+
+    bool isAvailable () const { return fLeader >= 0; }
+
+    /**
+     * @return true if `event` is being counted.
+     */
+    bool isCounting (Event event) const { return fFds[event] >= 0; }
+
+    /**
+     * @return why no counters could be opened; empty if they were.
+     */
+    const juce::String& getError () const { return fError; }
+
+    void start ();
+    Counts stop ();
+
+private:
+    std::array<int, kNumEvents> fFds;
+    int fLeader { -1 };
+    juce::String fError;
+
+    JUCE_DECLARE_NON_COPYABLE (PerfCounters)
+};
@@ -0,0 +1,200 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "keyedRunner.h"
+#include "stepCurves.h"
+
+/**
+ * A compile-time alternative to building `friz::Chain`/`friz::Sequence` graphs.
+ *
+ * ```
+ * using namespace pipeline;
+ * auto p = make (chain (sequence (move (inX, inY), move (outX, outY)),
+ *                       delay (250.f),
+ *                       value (step::Linear { 0.9f, 0.f, 500.f })),
+ *                sink);
+ * ```
+ *
+ * The whole pipeline is a single object whose type spells out its shape, so
+ * stepping it is a chain of inlined calls: no virtual functions, no
+ * `dynamic_cast`, and no allocations beyond wherever the pipeline itself is
+ * stored. Values are delivered to a sink object:
+ *
+ * - `sink (x, y)`         every frame of a `move` stage
+ * - `sink (v)`            every frame of a `value` stage
+ * - `sink.linkDone (i)`   when link `i` of a `chain` finishes
+ * - `sink.finished ()`    when the whole pipeline is done.
+ *
+ * Curves are the value types from `stepCurves.h`.
+ */
+namespace pipeline
+{
+/**
+ * A stage that steps one curve.
+ */
+template <typename Curve> struct Value
+{
+    template <typename Sink> bool step (float ms, Sink& sink)
+    {
+        const auto done { curve.step (ms) };
+        sink (curve.value);
+        return done;
+    }
+
+    Curve curve;
+};
+
+/**
+ * A stage that steps a pair of curves together, finishing when both have.
+ */
+template <typename CurveX, typename CurveY> struct Move
+{
+    template <typename Sink> bool step (float ms, Sink& sink)
+    {
+        const auto xDone { x.step (ms) };
+        const auto yDone { y.step (ms) };
+        sink (x.value, y.value);
+        return xDone && yDone;
+    }
+
+    CurveX x;
+    CurveY y;
+};
+
+/**
+ * A stage that just waits.
+ */
+struct Delay
+{
+    template <typename Sink> bool step (float ms, Sink&) { return wait.step (ms); }
+
+    step::Delay wait;
+};
+
+/**
+ * Runs its stages one after another. A chain also tells the sink each time one
+ * of its links finishes; a sequence doesn't.
+ */
+template <bool kNotify, typename... Stages> struct Serial
+{
+    static constexpr std::size_t kCount { sizeof...(Stages) };
+
+    template <typename Sink> bool step (float ms, Sink& sink)
+    {
+        return stepFrom<0> (ms, sink);
+    }
+
+    template <std::size_t I, typename Sink> bool stepFrom (float ms, Sink& sink)
+    {
+        if constexpr (I == kCount)
+            return true;
+        else
+        {
+            if (current != I)
+                return stepFrom<I + 1> (ms, sink);
+
+            if (!std::get<I> (stages).step (ms, sink))
+                return false;
+
+            ++current;
+            if constexpr (kNotify)
+                sink.linkDone (I);
+            return current == kCount;
+        }
+    }
+
+    std::tuple<Stages...> stages;
+    std::size_t current { 0 };
+};
+
+template <typename Root, typename Sink> struct Pipeline
+{
+    /**
+     * @return true once the pipeline has finished (and told its sink).
+     */
+    bool step (float ms)
+    {
+        if (done)
+            return true;
+        done = root.step (ms, sink);
+        if (done)
+            sink.finished ();
+        return done;
+    }
+
+    Root root;
+    Sink sink;
+    bool done { false };
+};
+
+template <typename Curve> Value<Curve> value (Curve curve)
+{
+    return { curve };
+}
+
+template <typename CurveX, typename CurveY> Move<CurveX, CurveY> move (CurveX x, CurveY y)
+{
+    return { x, y };
+}
+
+inline Delay delay (float ms)
+{
+    return { step::Delay { ms } };
+}
+
+template <typename... Stages> Serial<false, Stages...> sequence (Stages... stages)
+{
+    return { std::tuple<Stages...> { std::move (stages)... } };
+}
+
+template <typename... Stages> Serial<true, Stages...> chain (Stages... stages)
+{
+    return { std::tuple<Stages...> { std::move (stages)... } };
+}
+
+template <typename Root, typename Sink> Pipeline<Root, Sink> make (Root root, Sink sink)
+{
+    return { std::move (root), std::move (sink) };
+}
+
+/**
+ * How a `KeyedRunner` runs pipelines.
+ */
+struct Steps
+{
+    template <typename P> static void step (P& pipeline, float ms) { pipeline.step (ms); }
+    template <typename P> static bool isDone (const P& pipeline) { return pipeline.done; }
+};
+
+/**
+ * Runs any number of pipelines of a single type, stored by value in one
+ * contiguous block, and cancellable by key.
+ */
+template <typename P> using Runner = KeyedRunner<P, Steps>;
+} // namespace pipeline
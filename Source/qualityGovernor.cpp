@@ -0,0 +1,79 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "qualityGovernor.h"
+
+namespace
+{
+// below this fraction of the target frame rate, we've missed the budget...
+const float kMissedBudget { 0.9f };
+// ...and above this one, there's room to do more.
+const float kHeadroom { 0.97f };
+} // namespace
+
+QualityGovernor::QualityGovernor (float targetFps)
+: fTargetFps { targetFps }
+{
+}
+
+bool QualityGovernor::update (float framesPerSecond)
+{
+    const auto before { fLevel };
+
+    // no frames at all means nothing is animating, which is plenty of headroom.
+    const auto overBudget { framesPerSecond > 0.f &&
+                            framesPerSecond < fTargetFps * kMissedBudget };
+    const auto hasHeadroom { framesPerSecond <= 0.f ||
+                             framesPerSecond >= fTargetFps * kHeadroom };
+
+    fMissed   = overBudget ? fMissed + 1 : 0;
+    fHeadroom = hasHeadroom ? fHeadroom + 1 : 0;
+
+    if (fMissed >= kDegradeAfter && fLevel < kLowest)
+        setLevel (static_cast<Level> (fLevel + 1), framesPerSecond);
+    else if (fHeadroom >= kRecoverAfter && fLevel > kFull)
+        setLevel (static_cast<Level> (fLevel - 1), framesPerSecond);
+
+    return fLevel != before;
+}
+
+juce::String QualityGovernor::getName (Level level)
+{
+    switch (level)
+    {
+        case kFull: return "full";
+        case kThinCrumbs: return "thin crumbs";
+        case kNoBorders: return "no borders";
+        case kThrottleFades: return "throttled fades";
+        case kNoTooltips: return "no tooltips";
+    }
+    return {};
+}
+
+void QualityGovernor::setLevel (Level level, float framesPerSecond)
+{
+    juce::Logger::writeToLog ("quality: " + getName (fLevel) + " -> " + getName (level) +
+                              " (" + juce::String (framesPerSecond, 1) + " fps)");
+    fLevel    = level;
+    fMissed   = 0;
+    fHeadroom = 0;
+}
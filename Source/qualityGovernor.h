@@ -0,0 +1,86 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class QualityGovernor
+ * @brief Decides how much optional work the demo can afford, based on the
+ *        measured frame rate.
+ *
+ * Each time the frame budget is missed for `kDegradeAfter` samples in a row,
+ * quality drops one level; it only comes back up, one level at a time, after
+ * `kRecoverAfter` samples in a row with headroom. Levels are cumulative: each
+ * one also keeps every cut made by the levels above it.
+ */
+class QualityGovernor
+{
+public:
+    enum Level
+    {
+        kFull = 0,      ///< everything on
+        kThinCrumbs,    ///< only record some of the breadcrumb points
+        kNoBorders,     ///< boxes are drawn without their borders
+        kThrottleFades, ///< fading boxes repaint on fewer colour steps
+        kNoTooltips,    ///< the tooltip window (and its polling) is removed
+        kLowest = kNoTooltips
+    };
+
+    static constexpr int kDegradeAfter { 2 };
+    static constexpr int kRecoverAfter { 8 };
+
+    explicit QualityGovernor (float targetFps = 60.f);
+
+    /**
+     * Budget frames against this rate from now on; normally the refresh rate
+     * of the display we're drawing to, which a vsynced animator can't beat.
+     */
+    void setTargetFps (float targetFps) { fTargetFps = targetFps; }
+
+    float getTargetFps () const { return fTargetFps; }
+
+    /**
+     * Feed in the latest frame rate measurement.
+     * @return true if that changed the quality level.
+     */
+    bool update (float framesPerSecond);
+
+    Level getLevel () const { return fLevel; }
+
+    /**
+     * @return true if the cuts made at `level` are in effect.
+     */
+    bool isAtLeast (Level level) const { return fLevel >= level; }
+
+    static juce::String getName (Level level);
+
+private:
+    void setLevel (Level level, float framesPerSecond);
+
+private:
+    float fTargetFps;
+    Level fLevel { kFull };
+    int fMissed { 0 };
+    int fHeadroom { 0 };
+};
@@ -0,0 +1,169 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sharedTimeline.h"
+
+SharedTimeline::SharedTimeline (friz::Animator& animator, int clockId, float durationMs,
+                                std::function<float (float)> shape)
+: fClock (std::make_unique<FrameClock> (animator, clockId))
+, fDurationMs (durationMs)
+, fShape (std::move (shape))
+{
+    fClock->onFrame = [this] (float deltaMs) { advance (deltaMs); };
+}
+
+SharedTimeline::SharedTimeline (float durationMs, std::function<float (float)> shape)
+: fDurationMs (durationMs)
+, fShape (std::move (shape))
+{
+}
+
+void SharedTimeline::add (int id, float from, float to, float delayMs)
+{
+    const auto startMs { fNowMs + delayMs };
+
+    // everything added on the same frame (with the same delay) shares a cohort.
+    auto cohort { std::find_if (fCohorts.rbegin (), fCohorts.rend (),
+                                [startMs] (const Cohort& c)
+                                { return c.startMs == startMs; }) };
+    if (cohort == fCohorts.rend ())
+    {
+        fCohorts.push_back ({ startMs, {}, {}, {} });
+        cohort = fCohorts.rbegin ();
+    }
+
+    cohort->ids.push_back (id);
+    cohort->offsets.push_back (from);
+    cohort->scales.push_back (to - from);
+    ++fCount;
+    if (fClock != nullptr)
+        fClock->start ();
+}
+
+void SharedTimeline::cancel (int id)
+{
+    // an empty timeline holds nothing to cancel, and once its clock (or the
+    // scheduler task driving it) goes idle, no sweep would ever empty the set.
+    if (!fCohorts.empty ())
+        fCancelled.insert (id);
+}
+
+void SharedTimeline::restart (float durationMs)
+{
+    for (auto& cohort : fCohorts)
+    {
+        const auto now { evaluate (fNowMs - cohort.startMs) };
+        for (size_t i { 0 }; i < cohort.ids.size (); ++i)
+        {
+            const auto current { cohort.offsets[i] + cohort.scales[i] * now };
+            const auto end { cohort.offsets[i] + cohort.scales[i] };
+            cohort.offsets[i] = current;
+            cohort.scales[i]  = end - current;
+        }
+        // (a cohort that hadn't started yet keeps its start time.)
+        cohort.startMs = std::max (cohort.startMs, fNowMs);
+    }
+    fDurationMs = durationMs;
+}
+
+void SharedTimeline::clear ()
+{
+    fCohorts.clear ();
+    fCancelled.clear ();
+    fCount = 0;
+    if (fClock != nullptr)
+        fClock->stop ();
+}
+
+float SharedTimeline::evaluate (double elapsedMs) const
+{
+    const auto progress { static_cast<float> (
+        juce::jlimit (0.0, 1.0, elapsedMs / std::max (1.f, fDurationMs))) };
+    return fShape ? fShape (progress) : progress;
+}
+
+void SharedTimeline::advance (float deltaMs)
+{
+    fNowMs += deltaMs;
+    sweep ();
+
+    for (const auto& cohort : fCohorts)
+    {
+        const auto elapsed { fNowMs - cohort.startMs };
+        if (elapsed < 0.0)
+            continue;
+
+        // one curve evaluation for the whole cohort...
+        const auto curve { evaluate (elapsed) };
+
+        // ...then a tight loop applying it to each target.
+        const auto count { cohort.ids.size () };
+        fValues.resize (count);
+        for (size_t i { 0 }; i < count; ++i)
+            fValues[i] = cohort.offsets[i] + cohort.scales[i] * curve;
+
+        if (onValues)
+            onValues (cohort.ids.data (), fValues.data (), count);
+        if (elapsed >= fDurationMs && onFinished)
+            onFinished (cohort.ids.data (), count);
+    }
+
+    // (partition rather than remove_if, so the finished cohorts can still be
+    // counted.)
+    const auto finished { std::stable_partition (
+        fCohorts.begin (), fCohorts.end (),
+        [this] (const Cohort& c) { return fNowMs - c.startMs < fDurationMs; }) };
+    for (auto it { finished }; it != fCohorts.end (); ++it)
+        fCount -= it->ids.size ();
+    fCohorts.erase (finished, fCohorts.end ());
+
+    if (fCohorts.empty () && fClock != nullptr)
+        fClock->stop ();
+}
+
+void SharedTimeline::sweep ()
+{
+    if (fCancelled.empty ())
+        return;
+
+    for (auto& cohort : fCohorts)
+    {
+        size_t kept { 0 };
+        for (size_t i { 0 }; i < cohort.ids.size (); ++i)
+        {
+            if (fCancelled.count (cohort.ids[i]) != 0)
+                continue;
+            cohort.ids[kept]     = cohort.ids[i];
+            cohort.offsets[kept] = cohort.offsets[i];
+            cohort.scales[kept]  = cohort.scales[i];
+            ++kept;
+        }
+        fCount -= cohort.ids.size () - kept;
+        cohort.ids.resize (kept);
+        cohort.offsets.resize (kept);
+        cohort.scales.resize (kept);
+    }
+    fCohorts.erase (std::remove_if (fCohorts.begin (), fCohorts.end (),
+                                    [] (const Cohort& c) { return c.ids.empty (); }),
+                    fCohorts.end ());
+    fCancelled.clear ();
+}
@@ -0,0 +1,132 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "frameClock.h"
+
+#include <unordered_set>
+
+/**
+ * @class SharedTimeline
+ * @brief One curve, evaluated once per frame, driving any number of targets.
+ *
+ * Many animations are the same curve over the same duration, differing only
+ * in their end points and in when they started -- every box's fade, for one.
+ * Rather than each of them being its own animation with its own curve
+ * evaluation and update callback, targets are added to a shared timeline.
+ * Targets that start on the same frame form a cohort: each frame the curve is
+ * evaluated once per cohort, every target's value is computed from it with its
+ * own affine mapping (`from + (to - from) * curve`), and the whole cohort is
+ * handed to `onValues` in one call.
+ *
+ * The curve is a normalised shape: it maps progress 0..1 onto 0..1.
+ */
+class SharedTimeline
+{
+public:
+    /**
+     * @param animator   animator whose frames drive the timeline
+     * @param clockId    id for our clock animation on that animator
+     * @param durationMs how long every target takes to go from `from` to `to`.
+     * @param shape      normalised curve; linear if empty.
+     */
+    SharedTimeline (friz::Animator& animator, int clockId, float durationMs,
+                    std::function<float (float)> shape = {});
+
+    /**
+     * A timeline with no clock of its own, moved along by calling `advance ()`
+     * (from a `FrameScheduler` task, say).
+     */
+    explicit SharedTimeline (float durationMs, std::function<float (float)> shape = {});
+
+    /**
+     * Move the timeline on by `deltaMs`, updating every cohort that's started.
+     */
+    void advance (float deltaMs);
+
+    /**
+     * Start animating target `id` from `from` to `to`.
+     * @param delayMs start this much later than now (or earlier, if negative).
+     */
+    void add (int id, float from, float to, float delayMs = 0.f);
+
+    /**
+     * Stop updating `id`. Safe to call from the callbacks; the target is
+     * dropped at the start of the next frame. Does nothing while the timeline
+     * is empty.
+     */
+    void cancel (int id);
+
+    /**
+     * Change the duration, restarting every target from wherever it is now so
+     * it takes the new duration to get to its end value.
+     */
+    void restart (float durationMs);
+
+    void clear ();
+
+    size_t size () const { return fCount; }
+    size_t getCohortCount () const { return fCohorts.size (); }
+
+    /**
+     * Called once per cohort per frame with each target's id and new value.
+     * Neither callback may add targets.
+     */
+    std::function<void (const int* ids, const float* values, size_t count)> onValues;
+
+    /**
+     * Called once per cohort, after its final values, with the targets that
+     * have reached their end values.
+     */
+    std::function<void (const int* ids, size_t count)> onFinished;
+
+private:
+    struct Cohort
+    {
+        double startMs;
+        std::vector<int> ids;
+        /// value = offset + scale * curve
+        std::vector<float> offsets;
+        std::vector<float> scales;
+    };
+
+    float evaluate (double elapsedMs) const;
+
+    /**
+     * Drop cancelled targets (and any cohorts left empty).
+     */
+    void sweep ();
+
+private:
+    /// null if we're driven by someone else.
+    std::unique_ptr<FrameClock> fClock;
+    float fDurationMs;
+    std::function<float (float)> fShape;
+
+    double fNowMs { 0.0 };
+    std::vector<Cohort> fCohorts;
+    size_t fCount { 0 };
+    std::unordered_set<int> fCancelled;
+    /// scratch space for the values of one cohort.
+    std::vector<float> fValues;
+};
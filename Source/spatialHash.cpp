@@ -0,0 +1,71 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "spatialHash.h"
+
+namespace
+{
+// never use fewer buckets than this.
+const uint32_t kMinBuckets { 64 };
+} // namespace
+
+SpatialHash::SpatialHash (float cellSize)
+: fCellSize (cellSize)
+{
+    jassert (cellSize > 0.f);
+}
+
+void SpatialHash::rebuild (const std::vector<juce::Point<float>>& centres)
+{
+    const auto count { static_cast<uint32_t> (centres.size ()) };
+
+    // about two buckets per item keeps collisions rare.
+    const auto buckets { std::max (
+        kMinBuckets,
+        static_cast<uint32_t> (juce::nextPowerOfTwo (static_cast<int> (2 * count)))) };
+    fMask = buckets - 1;
+
+    fStart.assign (static_cast<size_t> (buckets) + 1, 0);
+    fBucketOf.resize (count);
+    fItems.resize (count);
+
+    // count the items in each bucket...
+    for (uint32_t i { 0 }; i < count; ++i)
+    {
+        const auto bucket { bucketOf (cellOf (centres[i].x), cellOf (centres[i].y)) };
+        fBucketOf[i] = bucket;
+        ++fStart[bucket + 1];
+    }
+
+    // ...turn the counts into start offsets...
+    for (size_t b { 1 }; b < fStart.size (); ++b)
+        fStart[b] += fStart[b - 1];
+
+    // ...and drop each item into place, using each bucket's start as its
+    // cursor. That leaves every start pointing at the next bucket, so shift
+    // them back afterwards.
+    for (uint32_t i { 0 }; i < count; ++i)
+        fItems[fStart[fBucketOf[i]]++] = i;
+    for (auto b { fStart.size () - 1 }; b > 0; --b)
+        fStart[b] = fStart[b - 1];
+    fStart[0] = 0;
+}
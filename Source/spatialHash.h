@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class SpatialHash
+ * @brief A uniform grid for finding the things near a point without checking
+ *        every other thing.
+ *
+ * Items are binned by the cell that contains their centre, and the cells are
+ * hashed into a power-of-two table of buckets that's rebuilt from scratch with
+ * a counting sort each time the items move -- two passes over the items, and no
+ * per-cell allocations. As long as no item is bigger than a cell, anything that
+ * overlaps an item has its centre in one of the 3x3 cells around the item's
+ * centre.
+ *
+ * Hash collisions mean a query can return a few items from other cells; the
+ * caller is expected to do its own exact test on whatever it gets back.
+ */
+class SpatialHash
+{
+public:
+    explicit SpatialHash (float cellSize);
+
+    /**
+     * Re-bin every item. Indices passed back by `forEachNear()` are indices
+     * into `centres`.
+     */
+    void rebuild (const std::vector<juce::Point<float>>& centres);
+
+    /**
+     * Call `fn (index)` for every item whose centre is in the cell containing
+     * `centre` or one of its eight neighbours (and possibly some others).
+     */
+    template <typename Fn>
+    void forEachNear (juce::Point<float> centre, Fn&& fn) const
+    {
+        if (fItems.empty ())
+            return;
+
+        const auto cx { cellOf (centre.x) };
+        const auto cy { cellOf (centre.y) };
+
+        // neighbouring cells can hash to the same bucket; only visit each once.
+        std::array<uint32_t, 9> visited;
+        size_t visitedCount { 0 };
+        for (int dy { -1 }; dy <= 1; ++dy)
+        {
+            for (int dx { -1 }; dx <= 1; ++dx)
+            {
+                const auto bucket { bucketOf (cx + dx, cy + dy) };
+                const auto end { visited.begin () + visitedCount };
+                if (std::find (visited.begin (), end, bucket) != end)
+                    continue;
+                visited[visitedCount++] = bucket;
+
+                for (auto i { fStart[bucket] }; i < fStart[bucket + 1]; ++i)
+                    fn (static_cast<size_t> (fItems[i]));
+            }
+        }
+    }
+
+    float getCellSize () const { return fCellSize; }
+
+private:
+    int cellOf (float coord) const
+    {
+        return static_cast<int> (std::floor (coord / fCellSize));
+    }
+
+    uint32_t bucketOf (int cx, int cy) const
+    {
+        const auto hash { static_cast<uint32_t> (cx) * 73856093u ^
+                          static_cast<uint32_t> (cy) * 19349663u };
+        return hash & fMask;
+    }
+
+private:
+    const float fCellSize;
+    uint32_t fMask { 0 };
+
+    /// items, sorted by bucket.
+    std::vector<uint32_t> fItems;
+    /// bucket `b` holds `fItems[fStart[b] .. fStart[b + 1])`.
+    std::vector<uint32_t> fStart;
+    /// scratch: the bucket of each item, so it's only hashed once.
+    std::vector<uint32_t> fBucketOf;
+};
@@ -0,0 +1,261 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "stageScaling.h"
+#include "MainComponent.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+const juce::String kStageScalingArg { "--stage-scaling" };
+
+// each phase lets the stages fill up with boxes before it starts measuring.
+const double kWarmupMs { 1500.0 };
+const double kPhaseMs { 5000.0 };
+
+// boxes are spawned on every stage at this rate.
+const int kSpawnHz { 10 };
+
+// a configuration is keeping up if its slowest stage stays above this.
+const double kKeepingUpFps { 54.0 };
+
+double nowMs ()
+{
+    return juce::Time::getMillisecondCounterHiRes ();
+}
+} // namespace
+
+StageScaling::StageScaling (const juce::String& commandLine)
+: fParams (MainComponent::createDefaultParams ())
+{
+    for (const auto& arg : juce::StringArray::fromTokens (commandLine, true))
+    {
+        if (arg.startsWith (kStageScalingArg + "="))
+            fOutput = juce::File::getCurrentWorkingDirectory ().getChildFile (
+                arg.fromFirstOccurrenceOf ("=", false, false).unquoted ());
+    }
+
+    // measure the animation, not the breadcrumbs.
+    fParams.setProperty (ID::kBreadcrumbs, false, nullptr);
+
+    for (auto shared : { false, true })
+    {
+        for (int stages { 1 }; stages <= 64; stages *= 2)
+            fPhases.push_back ({ stages, shared });
+    }
+
+    setSize (1000, 740);
+    startPhase ();
+    startTimerHz (kSpawnHz);
+}
+
+StageScaling::~StageScaling ()
+{
+    stopTimer ();
+    removeStages ();
+}
+
+bool StageScaling::isRequested (const juce::String& commandLine)
+{
+    return commandLine.contains (kStageScalingArg);
+}
+
+void StageScaling::resized ()
+{
+    if (fStages.empty ())
+        return;
+
+    const auto count { static_cast<int> (fStages.size ()) };
+    const auto cols { static_cast<int> (std::ceil (std::sqrt (count))) };
+    const auto rows { (count + cols - 1) / cols };
+    const auto width { getWidth () / cols };
+    const auto height { getHeight () / rows };
+
+    for (int i { 0 }; i < count; ++i)
+    {
+        fStages[static_cast<size_t> (i)]->setBounds (
+            (i % cols) * width, (i / cols) * height, width, height);
+    }
+}
+
+void StageScaling::timerCallback ()
+{
+    auto& r { juce::Random::getSystemRandom () };
+    for (auto& stage : fStages)
+    {
+        const juce::Point<int> point {
+            r.nextInt (std::max (1, stage->getWidth () / 2)),
+            r.nextInt (std::max (1, stage->getHeight () / 2)) };
+        stage->createDemo (point, DemoComponent::EffectType::kEaseIn);
+    }
+
+    const auto now { nowMs () };
+    if (now - fPhaseStartMs < kWarmupMs)
+        return;
+
+    if (fSamples == 0)
+    {
+        fSampleStartMs  = now;
+        fSampleStartCpu = std::clock ();
+        fWakeups        = 0;
+    }
+
+    double rateSum { 0.0 };
+    double minRate { 1000.0 };
+    for (auto& stage : fStages)
+    {
+        const auto rate { static_cast<double> (stage->getFrameRate ()) };
+        rateSum += rate;
+        minRate = std::min (minRate, rate);
+    }
+    const auto meanRate { rateSum / static_cast<double> (fStages.size ()) };
+
+    fFrameRateSum += meanRate;
+    fMinFrameRate = (fSamples == 0) ? minRate : std::min (fMinFrameRate, minRate);
+    ++fSamples;
+
+    if (now - fPhaseStartMs >= kWarmupMs + kPhaseMs)
+        finishPhase ();
+}
+
+void StageScaling::startPhase ()
+{
+    const auto& phase { fPhases[fPhase] };
+    if (phase.shared)
+    {
+        fSharedAnimator = std::make_unique<friz::Animator> ();
+#if FRIZ_VBLANK_ENABLED
+        // the same display-synced timing that each stage gives its own animator.
+        fSharedAnimator->setController (
+            std::make_unique<friz::DisplaySyncController> (this));
+#endif
+    }
+
+    for (int i { 0 }; i < phase.stages; ++i)
+    {
+        fStages.push_back (
+            std::make_unique<DemoComponent> (fParams, fSharedAnimator.get ()));
+        addAndMakeVisible (fStages.back ().get ());
+    }
+    resized ();
+
+    // a shared animator is one timer for everyone; otherwise each stage has its
+    // own. Either way, count the frames each controller really delivers.
+    if (fSharedAnimator != nullptr)
+        addWakeupClock (*fSharedAnimator);
+    else
+    {
+        for (auto& stage : fStages)
+            addWakeupClock (stage->getAnimator ());
+    }
+
+    fPhaseStartMs = nowMs ();
+    fSamples      = 0;
+    fFrameRateSum = 0.0;
+    fMinFrameRate = 0.0;
+    fWakeups      = 0;
+}
+
+void StageScaling::addWakeupClock (friz::Animator& animator)
+{
+    auto clock { std::make_unique<FrameClock> (animator,
+                                               DemoComponent::allocateClockId ()) };
+    clock->onFrame = [this] (float /*deltaMs*/) { ++fWakeups; };
+    clock->start ();
+    fWakeupClocks.push_back (std::move (clock));
+}
+
+void StageScaling::finishPhase ()
+{
+    auto& phase { fPhases[fPhase] };
+    phase.keptUp = fMinFrameRate >= kKeepingUpFps;
+
+    const auto wallMs { nowMs () - fSampleStartMs };
+    const auto cpuMs { 1000.0 * static_cast<double> (std::clock () - fSampleStartCpu) /
+                       CLOCKS_PER_SEC };
+    const auto samples { static_cast<double> (std::max (1, fSamples)) };
+    const auto meanRate { fFrameRateSum / samples };
+
+    juce::DynamicObject::Ptr result { new juce::DynamicObject };
+    result->setProperty ("stages", phase.stages);
+    result->setProperty ("animator", phase.shared ? "shared" : "perStage");
+    result->setProperty ("meanFps", meanRate);
+    result->setProperty ("minFps", fMinFrameRate);
+    result->setProperty ("frameMs", meanRate > 0.0 ? 1000.0 / meanRate : 0.0);
+    result->setProperty ("timerWakeupsPerSec",
+                         wallMs > 0.0 ? 1000.0 * fWakeups / wallMs : 0.0);
+    result->setProperty ("cpuPercent", wallMs > 0.0 ? 100.0 * cpuMs / wallMs : 0.0);
+    result->setProperty ("keepingUp", phase.keptUp);
+    fResults.add (juce::var (result.get ()));
+
+    removeStages ();
+    if (++fPhase < fPhases.size ())
+        startPhase ();
+    else
+        finish ();
+}
+
+void StageScaling::finish ()
+{
+    stopTimer ();
+
+    // for each architecture, the most stages that kept up before the first one
+    // that didn't.
+    juce::DynamicObject::Ptr summary { new juce::DynamicObject };
+    for (auto shared : { false, true })
+    {
+        int scalesTo { 0 };
+        for (const auto& phase : fPhases)
+        {
+            if (phase.shared != shared)
+                continue;
+            if (!phase.keptUp)
+                break;
+            scalesTo = phase.stages;
+        }
+        summary->setProperty (shared ? "sharedScalesTo" : "perStageScalesTo", scalesTo);
+    }
+
+    juce::DynamicObject::Ptr output { new juce::DynamicObject };
+    output->setProperty ("phases", fResults);
+    output->setProperty ("summary", juce::var (summary.get ()));
+
+    const auto json { juce::JSON::toString (juce::var (output.get ())) };
+    auto* app { juce::JUCEApplication::getInstance () };
+    if (fOutput == juce::File ())
+        std::cout << json << std::endl;
+    else if (!fOutput.replaceWithText (json))
+        app->setApplicationReturnValue (1);
+
+    app->systemRequestedQuit ();
+}
+
+void StageScaling::removeStages ()
+{
+    // stages cancel their own animations as they're destroyed, so they have to
+    // go before the animator they share; the wakeup clocks go before either.
+    fWakeupClocks.clear ();
+    fStages.clear ();
+    fSharedAnimator.reset ();
+}
@@ -0,0 +1,93 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "demoComponent.h"
+#include "frameClock.h"
+
+#include <ctime>
+
+/**
+ * @class StageScaling
+ * @brief Benchmark: how do many independent stages in one window scale?
+ *
+ * Launching the app with `--stage-scaling[=<path>]` opens a window showing
+ * this component instead of the demo. It tiles N `DemoComponent` stages
+ * (N = 1, 2, 4 ... 64), keeps boxes spawning on all of them, and measures
+ * frame rate, animator timer wakeups and CPU use; first with an animator per
+ * stage, then with every stage sharing a single animator. The results are
+ * written as JSON to the file (or stdout) and the app quits.
+ */
+class StageScaling : public juce::Component,
+                     private juce::Timer
+{
+public:
+    explicit StageScaling (const juce::String& commandLine);
+    ~StageScaling ();
+
+    static bool isRequested (const juce::String& commandLine);
+
+    void resized () override;
+
+private:
+    struct Phase
+    {
+        int stages;
+        bool shared;
+        bool keptUp { false };
+    };
+
+    void timerCallback () override;
+
+    void startPhase ();
+    void addWakeupClock (friz::Animator& animator);
+    void finishPhase ();
+    void finish ();
+
+    void removeStages ();
+
+private:
+    juce::ValueTree fParams;
+    juce::File fOutput;
+
+    std::vector<Phase> fPhases;
+    size_t fPhase { 0 };
+
+    std::unique_ptr<friz::Animator> fSharedAnimator;
+    std::vector<std::unique_ptr<DemoComponent>> fStages;
+    /// One per animator, counting the frames its controller actually delivers.
+    std::vector<std::unique_ptr<FrameClock>> fWakeupClocks;
+
+    // measurements for the current phase
+    double fPhaseStartMs { 0.0 };
+    double fSampleStartMs { 0.0 };
+    std::clock_t fSampleStartCpu { 0 };
+    int fSamples { 0 };
+    double fFrameRateSum { 0.0 };
+    double fMinFrameRate { 0.0 };
+    int fWakeups { 0 };
+
+    juce::Array<juce::var> fResults;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StageScaling)
+};
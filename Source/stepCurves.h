@@ -0,0 +1,200 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Lightweight, non-virtual value types that step a single value toward a target
+ * a frame at a time. They follow the same parameters as the friz curves with the
+ * same names (tolerance, slew, acceleration, damping), so code that can't (or
+ * doesn't want to) go through a `friz::AnimatedValue` can still produce the
+ * same kinds of motion.
+ *
+ * Each has a `value` member and a `step (ms)` method that advances the curve
+ * and returns true once it has reached its end. Per-frame constants are
+ * defined in terms of a 60 Hz frame and scaled by the actual elapsed time.
+ */
+namespace step
+{
+constexpr float kFrameMs { 1000.f / 60.f };
+
+/**
+ * Moves from start to end at a constant rate over a fixed duration.
+ */
+struct Linear
+{
+    Linear (float startVal, float endVal, float durationMs)
+    : value { startVal }
+    , start { startVal }
+    , end { endVal }
+    , duration { durationMs }
+    {
+    }
+
+    bool step (float ms)
+    {
+        elapsed = std::min (elapsed + ms, duration);
+        value   = (duration > 0.f) ? start + (end - start) * (elapsed / duration) : end;
+        return elapsed >= duration;
+    }
+
+    float value;
+    float start;
+    float end;
+    float duration;
+    float elapsed { 0.f };
+};
+
+/**
+ * Waits for a fixed time without changing its value.
+ */
+struct Delay
+{
+    explicit Delay (float durationMs)
+    : duration { durationMs }
+    {
+    }
+
+    bool step (float ms)
+    {
+        elapsed += ms;
+        return elapsed >= duration;
+    }
+
+    float value { 0.f };
+    float duration;
+    float elapsed { 0.f };
+};
+
+/**
+ * Covers `slew` (0..1) of the remaining distance each frame, slowing as it
+ * approaches the end; finishes when within `tolerance` of it.
+ */
+struct EaseIn
+{
+    EaseIn (float startVal, float endVal, float tolerance_, float slew_)
+    : value { startVal }
+    , end { endVal }
+    , tolerance { tolerance_ }
+    , slew { slew_ }
+    {
+    }
+
+    bool step (float ms)
+    {
+        const auto frames { ms / kFrameMs };
+        value += (end - value) * (1.f - std::pow (1.f - slew, frames));
+        if (std::abs (end - value) < tolerance)
+        {
+            value = end;
+            return true;
+        }
+        return false;
+    }
+
+    float value;
+    float end;
+    float tolerance;
+    float slew;
+};
+
+/**
+ * Starts moving at `tolerance` units per frame and multiplies its speed by
+ * `slew` (> 1) every frame until it reaches the end.
+ */
+struct EaseOut
+{
+    EaseOut (float startVal, float endVal, float tolerance_, float slew_)
+    : value { startVal }
+    , end { endVal }
+    , speed { std::max (tolerance_, 0.01f) }
+    , slew { slew_ }
+    {
+    }
+
+    bool step (float ms)
+    {
+        const auto frames { ms / kFrameMs };
+        speed *= std::pow (slew, frames);
+        const auto remaining { end - value };
+        const auto distance { speed * frames };
+        if (distance >= std::abs (remaining))
+        {
+            value = end;
+            return true;
+        }
+        value += std::copysign (distance, remaining);
+        return false;
+    }
+
+    float value;
+    float end;
+    float speed;
+    float slew;
+};
+
+/**
+ * Accelerates toward the end by `accel` units per frame per frame; each time it
+ * overshoots, its velocity is scaled by `damping`. Finishes when both its
+ * distance from the end and its velocity are within `tolerance`.
+ */
+struct Spring
+{
+    Spring (float startVal, float endVal, float tolerance_, float accel_, float damping_)
+    : value { startVal }
+    , end { endVal }
+    , tolerance { tolerance_ }
+    , accel { accel_ }
+    , damping { damping_ }
+    {
+    }
+
+    bool step (float ms)
+    {
+        const auto frames { ms / kFrameMs };
+        const auto before { end - value };
+        velocity += std::copysign (accel, before) * frames;
+        value += velocity * frames;
+
+        const auto after { end - value };
+        if ((before < 0.f) != (after < 0.f))
+            velocity *= damping;
+
+        if (std::abs (after) < tolerance && std::abs (velocity) < tolerance)
+        {
+            value = end;
+            return true;
+        }
+        return false;
+    }
+
+    float value;
+    float end;
+    float tolerance;
+    float accel;
+    float damping;
+    float velocity { 0.f };
+};
+} // namespace step
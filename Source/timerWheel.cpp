@@ -0,0 +1,105 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "timerWheel.h"
+
+void TimerWheel::schedule (int id, double delayMs)
+{
+    // a delay of zero still waits for the next tick; the current one has
+    // already fired.
+    const auto maxTicks { (uint64_t { 1 } << (kLevels * kSlotBits)) - 1 };
+    const auto wanted { std::ceil (std::max (0.0, delayMs) / kTickMs) };
+    const auto ticks { juce::jlimit (uint64_t { 1 }, maxTicks,
+                                     static_cast<uint64_t> (wanted)) };
+    place ({ id, fNow + ticks });
+    ++fCount;
+}
+
+void TimerWheel::advance (double deltaMs)
+{
+    fCarryMs += deltaMs;
+    while (fCarryMs >= kTickMs)
+    {
+        fCarryMs -= kTickMs;
+        tick ();
+    }
+}
+
+void TimerWheel::clear ()
+{
+    for (auto& level : fWheel)
+    {
+        for (auto& slot : level)
+            slot.clear ();
+    }
+    fCount = 0;
+}
+
+void TimerWheel::place (const Entry& entry)
+{
+    const auto wait { entry.dueTick - fNow };
+    for (int level { 0 }; level < kLevels; ++level)
+    {
+        const auto shift { level * kSlotBits };
+        if (wait < (kSlots << shift) || level == kLevels - 1)
+        {
+            fWheel[static_cast<size_t> (level)][(entry.dueTick >> shift) & kSlotMask]
+                .push_back (entry);
+            return;
+        }
+    }
+}
+
+void TimerWheel::tick ()
+{
+    ++fNow;
+
+    // at each wrap of a finer level, pull the next slot of the coarser one down
+    // -- coarsest first, so its entries can land in the slot cascaded next.
+    for (int level { kLevels - 1 }; level > 0; --level)
+    {
+        const auto shift { level * kSlotBits };
+        if ((fNow & ((uint64_t { 1 } << shift) - 1)) != 0)
+            continue;
+
+        auto& slot { fWheel[static_cast<size_t> (level)][(fNow >> shift) & kSlotMask] };
+        fScratch.swap (slot);
+        for (const auto& entry : fScratch)
+            place (entry);
+        fScratch.clear ();
+    }
+
+    auto& due { fWheel[0][fNow & kSlotMask] };
+    if (due.empty ())
+        return;
+
+    // `onDue` may schedule more entries, so fire from a copy of the slot.
+    fScratch.swap (due);
+    fCount -= fScratch.size ();
+    for (const auto& entry : fScratch)
+    {
+        jassert (entry.dueTick == fNow);
+        if (onDue)
+            onDue (entry.id);
+    }
+    fScratch.clear ();
+}
@@ -0,0 +1,92 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include "animatorApp.h"
+
+/**
+ * @class TimerWheel
+ * @brief Holds ids until they're due, at a cost that doesn't depend on how
+ *        many are waiting.
+ *
+ * A hierarchical timing wheel: three levels of 64 slots each. Level 0 slots
+ * are one tick (`kTickMs`) wide, level 1 slots are 64 ticks wide, and level 2
+ * slots are 64 * 64 ticks wide. An entry goes into the coarsest level that
+ * can hold it. Each tick fires one level 0 slot. Every 64 ticks, one level 1
+ * slot is cascaded back down into level 0, and the same happens between
+ * levels 2 and 1. Advancing the wheel therefore only touches entries that are
+ * due or being cascaded, never the rest of the waiting entries.
+ *
+ * Delays are rounded up to whole ticks and capped at the span of the wheel
+ * (about 35 minutes).
+ */
+class TimerWheel
+{
+public:
+    static constexpr double kTickMs { 8.0 };
+
+    /**
+     * Park `id` for `delayMs`; `onDue (id)` is called from the `advance()`
+     * that takes the wheel past that time.
+     */
+    void schedule (int id, double delayMs);
+
+    /**
+     * Move time forward, firing every entry that comes due.
+     */
+    void advance (double deltaMs);
+
+    /**
+     * Drop every waiting entry without firing it.
+     */
+    void clear ();
+
+    size_t size () const { return fCount; }
+    bool isEmpty () const { return fCount == 0; }
+
+    std::function<void (int id)> onDue;
+
+private:
+    static constexpr int kLevels { 3 };
+    static constexpr int kSlotBits { 6 };
+    static constexpr uint64_t kSlots { 1 << kSlotBits };
+    static constexpr uint64_t kSlotMask { kSlots - 1 };
+
+    struct Entry
+    {
+        int id;
+        uint64_t dueTick;
+    };
+
+    void place (const Entry& entry);
+    void tick ();
+
+private:
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> fWheel;
+    /// reused to hold a slot's entries while they're fired or cascaded.
+    std::vector<Entry> fScratch;
+
+    uint64_t fNow { 0 };
+    double fCarryMs { 0.0 };
+    size_t fCount { 0 };
+};
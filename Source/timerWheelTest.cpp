@@ -0,0 +1,182 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include "subTest.h"
+#include "timerWheel.h"
+
+#include <map>
+
+namespace
+{
+/**
+ * Drives a wheel one tick at a time, remembering the tick on which each id fired.
+ */
+class WheelHarness
+{
+public:
+    WheelHarness ()
+    {
+        wheel.onDue = [this] (int id) { fired[id].push_back (now); };
+    }
+
+    void schedule (int id, uint64_t ticks)
+    {
+        wheel.schedule (id, static_cast<double> (ticks) * TimerWheel::kTickMs);
+    }
+
+    void run (uint64_t ticks)
+    {
+        for (uint64_t i { 0 }; i < ticks; ++i)
+        {
+            ++now;
+            wheel.advance (TimerWheel::kTickMs);
+        }
+    }
+
+    TimerWheel wheel;
+    uint64_t now { 0 };
+    std::map<int, std::vector<uint64_t>> fired;
+};
+
+// the longest delay the three 64-slot levels can hold.
+const uint64_t kMaxTicks { (uint64_t { 1 } << 18) - 1 };
+} // namespace
+
+class TimerWheelTest : public SubTest
+{
+public:
+    TimerWheelTest ()
+    : SubTest ("TimerWheel", "frizDemo")
+    {
+    }
+
+    void runTest () override
+    {
+        Test ("Fires on the due tick across level boundaries",
+              [this] ()
+              {
+                  const std::vector<uint64_t> delays { 1,    63,   64,   65,
+                                                       4095, 4096, 4097, 8191,
+                                                       8192, kMaxTicks };
+                  // start from ticks that aren't aligned to either coarser level, too.
+                  for (const uint64_t offset : { 0, 1, 63, 64, 4095, 5000 })
+                  {
+                      WheelHarness h;
+                      h.run (offset);
+                      for (size_t i { 0 }; i < delays.size (); ++i)
+                          h.schedule (static_cast<int> (i), delays[i]);
+                      expectEquals (h.wheel.size (), delays.size ());
+
+                      h.run (kMaxTicks + 1);
+                      expect (h.wheel.isEmpty ());
+                      for (size_t i { 0 }; i < delays.size (); ++i)
+                      {
+                          const auto& ticks { h.fired[static_cast<int> (i)] };
+                          expectEquals (ticks.size (), size_t { 1 });
+                          if (!ticks.empty ())
+                              expect (ticks[0] == offset + delays[i],
+                                      "delay " + juce::String (delays[i]) +
+                                          " from tick " + juce::String (offset));
+                      }
+                  }
+              });
+
+        Test ("Delays are capped at the span of the wheel",
+              [this] ()
+              {
+                  WheelHarness h;
+                  h.run (100);
+                  h.wheel.schedule (1, 1.0e12);
+                  h.schedule (2, kMaxTicks + 1000);
+                  h.run (kMaxTicks + 1);
+                  for (const int id : { 1, 2 })
+                  {
+                      expectEquals (h.fired[id].size (), size_t { 1 });
+                      if (!h.fired[id].empty ())
+                          expect (h.fired[id][0] == 100 + kMaxTicks);
+                  }
+              });
+
+        Test ("A zero delay waits for the next tick",
+              [this] ()
+              {
+                  WheelHarness h;
+                  h.schedule (1, 0);
+                  h.wheel.schedule (2, 0.5);
+                  h.run (1);
+                  expectEquals (h.fired[1].size (), size_t { 1 });
+                  expectEquals (h.fired[2].size (), size_t { 1 });
+                  expect (h.wheel.isEmpty ());
+              });
+
+        Test ("Scheduling from inside onDue",
+              [this] ()
+              {
+                  WheelHarness h;
+                  std::vector<std::pair<int, uint64_t>> chain;
+                  h.wheel.onDue = [&] (int id)
+                  {
+                      h.fired[id].push_back (h.now);
+                      // each firing parks the next id, crossing the level boundaries.
+                      if (id == 1)
+                          h.schedule (2, 0);
+                      else if (id == 2)
+                          h.schedule (3, 64);
+                      else if (id == 3)
+                          h.schedule (4, 4096);
+                  };
+                  h.schedule (1, 10);
+                  h.run (10 + 1 + 64 + 4096 + 10);
+                  expect (h.wheel.isEmpty ());
+                  const std::vector<uint64_t> expected { 10, 11, 75, 4171 };
+                  for (size_t i { 0 }; i < expected.size (); ++i)
+                  {
+                      const auto& ticks { h.fired[static_cast<int> (i + 1)] };
+                      expectEquals (ticks.size (), size_t { 1 });
+                      if (!ticks.empty ())
+                          expect (ticks[0] == expected[i]);
+                  }
+              });
+
+        Test ("Clear drops everything without firing",
+              [this] ()
+              {
+                  WheelHarness h;
+                  h.schedule (1, 5);
+                  h.schedule (2, 100);
+                  h.schedule (3, 5000);
+                  h.wheel.clear ();
+                  expect (h.wheel.isEmpty ());
+                  h.run (6000);
+                  expect (h.fired.empty ());
+
+                  // ...and the wheel is still usable afterwards.
+                  h.schedule (4, 70);
+                  expectEquals (h.wheel.size (), size_t { 1 });
+                  h.run (70);
+                  expectEquals (h.fired[4].size (), size_t { 1 });
+                  if (!h.fired[4].empty ())
+                      expect (h.fired[4][0] == 6070);
+              });
+    }
+};
+
+static TimerWheelTest timerWheelTest;
@@ -0,0 +1,135 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "trajectoryCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace
+{
+// curves that never settle are cut off after this.
+const int kMaxFrames { 1200 };
+
+// the cache is cleared if it grows past this many trajectories.
+const std::size_t kMaxPaths { 1024 };
+
+template <typename Curve> std::vector<float> sample (Curve curve, float span)
+{
+    std::vector<float> progress;
+    progress.push_back (0.f);
+    bool done { false };
+    for (int frame { 0 }; !done && frame < kMaxFrames; ++frame)
+    {
+        done = curve.step (step::kFrameMs);
+        progress.push_back (curve.value / span);
+    }
+    progress.back () = 1.f;
+    return progress;
+}
+} // namespace
+
+bool TrajectoryCache::Replay::step (float ms)
+{
+    elapsed += ms;
+    const auto& progress { *path };
+    const auto pos { elapsed / step::kFrameMs };
+    const auto index { static_cast<std::size_t> (pos) };
+    if (index + 1 >= progress.size ())
+    {
+        value = end;
+        return true;
+    }
+
+    const auto frac { pos - static_cast<float> (index) };
+    const auto p { progress[index] + (progress[index + 1] - progress[index]) * frac };
+    value = start + (end - start) * p;
+    return false;
+}
+
+TrajectoryCache::Replay TrajectoryCache::easeIn (float start, float end, float tolerance,
+                                                 float slew)
+{
+    return replay (Shape::kEaseIn, start, end, tolerance, slew);
+}
+
+TrajectoryCache::Replay TrajectoryCache::easeOut (float start, float end,
+                                                  float tolerance, float slew)
+{
+    return replay (Shape::kEaseOut, start, end, tolerance, slew);
+}
+
+TrajectoryCache::Replay TrajectoryCache::replay (Shape shape, float start, float end,
+                                                 float a, float b)
+{
+    return { start, start, end, get (shape, std::abs (end - start), a, b) };
+}
+
+TrajectoryCache::Path TrajectoryCache::get (Shape shape, float span, float a, float b)
+{
+    const auto quanta { std::max (1, juce::roundToInt (span / kSpanQuantum)) };
+    const Key key { shape, quanta, a, b };
+
+    if (auto it { fPaths.find (key) }; it != fPaths.end ())
+    {
+        ++fHits;
+        return it->second;
+    }
+
+    ++fMisses;
+    if (fPaths.size () >= kMaxPaths)
+        clear ();
+    auto path { simulate (key) };
+    fPaths.emplace (key, path);
+    return path;
+}
+
+void TrajectoryCache::clear ()
+{
+    fPaths.clear ();
+}
+
+std::size_t TrajectoryCache::KeyHash::operator() (const Key& key) const
+{
+    std::size_t seed { std::hash<int> {}(static_cast<int> (key.shape)) };
+    for (auto h : { std::hash<int> {}(key.span), std::hash<float> {}(key.a),
+                    std::hash<float> {}(key.b) })
+        seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+TrajectoryCache::Path TrajectoryCache::simulate (const Key& key)
+{
+    const auto span { static_cast<float> (key.span) * kSpanQuantum };
+    switch (key.shape)
+    {
+        case Shape::kEaseIn:
+            return std::make_shared<const std::vector<float>> (
+                sample (step::EaseIn { 0.f, span, key.a, key.b }, span));
+
+        case Shape::kEaseOut:
+            return std::make_shared<const std::vector<float>> (
+                sample (step::EaseOut { 0.f, span, key.a, key.b }, span));
+    }
+    return {};
+}
@@ -0,0 +1,121 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "animatorApp.h"
+#include "stepCurves.h"
+
+/**
+ * @class TrajectoryCache
+ * @brief Memoises the shape of the simulated curves so that boxes with the same
+ *        parameters replay one precomputed trajectory instead of simulating
+ *        their own.
+ *
+ * A trajectory is the curve's normalised (0..1) progress sampled once per
+ * 60 Hz frame. It's scaled to each box's own start/end points as it's replayed.
+ *
+ * The shape of these curves isn't completely scale-free -- their tolerances
+ * and accelerations are in absolute units, so a longer move takes a few more
+ * frames -- so the distance travelled is part of the key, rounded to
+ * `kSpanQuantum` pixels.
+ */
+class TrajectoryCache
+{
+public:
+    enum class Shape
+    {
+        kEaseIn = 0,
+        kEaseOut
+    };
+
+    /// progress values, one per frame; the first is 0 and the last is 1.
+    using Path = std::shared_ptr<const std::vector<float>>;
+
+    static constexpr float kSpanQuantum { 16.f };
+
+    /**
+     * Steps through a cached trajectory, scaled to run from `start` to `end`.
+     * Has the same `value`/`step ()` interface as the curves in `stepCurves.h`.
+     */
+    struct Replay
+    {
+        bool step (float ms);
+
+        float value;
+        float start;
+        float end;
+        Path path;
+        float elapsed { 0.f };
+    };
+
+    Replay easeIn (float start, float end, float tolerance, float slew);
+    Replay easeOut (float start, float end, float tolerance, float slew);
+
+    /**
+     * Find (or simulate and store) the normalised trajectory for a shape.
+     */
+    Path get (Shape shape, float span, float a, float b);
+
+    /**
+     * Drop every stored trajectory. Replays already in progress keep theirs.
+     */
+    void clear ();
+
+    std::size_t size () const { return fPaths.size (); }
+    std::size_t getHits () const { return fHits; }
+    std::size_t getMisses () const { return fMisses; }
+
+private:
+    struct Key
+    {
+        Shape shape;
+        int span;
+        float a;
+        float b;
+
+        bool operator== (const Key& other) const
+        {
+            return shape == other.shape && span == other.span && a == other.a &&
+                   b == other.b;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator() (const Key& key) const;
+    };
+
+    Replay replay (Shape shape, float start, float end, float a, float b);
+
+    static Path simulate (const Key& key);
+
+private:
+    std::unordered_map<Key, Path, KeyHash> fPaths;
+    std::size_t fHits { 0 };
+    std::size_t fMisses { 0 };
+};
@@ -0,0 +1,149 @@
+/*
+    Copyright (c) 2019-2023 Brett g Porter
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Offline decoder for the flight recorder's ring file: prints every intact
+ * record, oldest first, as CSV.
+ *
+ *     c++ -std=c++20 -O2 -I Source Tools/flightDecode.cpp -o flightDecode
+ *     flightDecode flight.bin [out.csv]
+ *
+ * Columns that don't apply to a record's type are left empty. `time_ms` is
+ * wall-clock time in ms since 1970.
+ */
+
+#include "flightRecord.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+const char* typeName (flight::Type type)
+{
+    switch (type)
+    {
+        case flight::Type::kFrame: return "frame";
+        case flight::Type::kSample: return "sample";
+        case flight::Type::kSpawn: return "spawn";
+    }
+    return "unknown";
+}
+
+void writeRecord (std::FILE* out, const flight::Header& header, const flight::Record& r)
+{
+    const auto timeMs { header.startMs + static_cast<int64_t> (r.timeUs / 1000) };
+    std::fprintf (out, "%" PRIu64 ",%" PRId64 ",%s,", r.sequence, timeMs,
+                  typeName (r.type));
+
+    if (r.type == flight::Type::kFrame)
+        std::fprintf (out, "%.3f,%u,%u,%u,", r.frame.frameMs, r.frame.liveBoxes,
+                      r.frame.boxList, r.frame.crumbVertices);
+    else
+        std::fprintf (out, ",,,,");
+
+    if (r.type == flight::Type::kSample)
+        std::fprintf (out, "%.1f,%u,%u,%u,%u,%u,%u,%u,%u,", r.sample.fps, r.sample.rssKb,
+                      r.sample.movements, r.sample.scripts, r.sample.pipelines,
+                      r.sample.fades, r.sample.waitingFades, r.sample.spawnQueue,
+                      r.sample.quality);
+    else
+        std::fprintf (out, ",,,,,,,,,");
+
+    if (r.type == flight::Type::kSpawn)
+        std::fprintf (out, "%d,%d,%d,%u\n", r.spawn.boxId, r.spawn.x, r.spawn.y,
+                      r.spawn.effect);
+    else
+        std::fprintf (out, ",,,\n");
+}
+} // namespace
+
+int main (int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::fprintf (stderr, "usage: %s <recording> [out.csv]\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream in { argv[1], std::ios::binary };
+    const std::vector<char> data { std::istreambuf_iterator<char> (in),
+                                   std::istreambuf_iterator<char> () };
+
+    flight::Header header;
+    if (data.size () < sizeof (header))
+    {
+        std::fprintf (stderr, "%s: not a flight recording\n", argv[1]);
+        return 1;
+    }
+    std::memcpy (&header, data.data (), sizeof (header));
+    if (std::memcmp (header.magic, flight::kMagic, sizeof (flight::kMagic)) != 0 ||
+        header.version != flight::kVersion ||
+        header.recordSize != sizeof (flight::Record) || header.capacity == 0 ||
+        data.size () < sizeof (header) + header.capacity * sizeof (flight::Record))
+    {
+        std::fprintf (stderr, "%s: not a flight recording (or a different version)\n",
+                      argv[1]);
+        return 1;
+    }
+
+    // keep every record that's where its sequence number says it should be.
+    std::vector<flight::Record> records;
+    records.reserve (header.capacity);
+    const auto* slots { data.data () + sizeof (header) };
+    for (uint64_t slot { 0 }; slot < header.capacity; ++slot)
+    {
+        flight::Record record;
+        std::memcpy (&record, slots + slot * sizeof (record), sizeof (record));
+        if (record.sequence != 0 && (record.sequence - 1) % header.capacity == slot)
+            records.push_back (record);
+    }
+    std::sort (records.begin (), records.end (),
+               [] (const flight::Record& a, const flight::Record& b)
+               { return a.sequence < b.sequence; });
+
+    auto* out { argc == 3 ? std::fopen (argv[2], "w") : stdout };
+    if (out == nullptr)
+    {
+        std::fprintf (stderr, "can't write %s\n", argv[2]);
+        return 1;
+    }
+
+    std::fprintf (out, "sequence,time_ms,type,"
+                       "frame_ms,live_boxes,box_list,crumb_vertices,"
+                       "fps,rss_kb,movements,scripts,pipelines,fades,waiting_fades,"
+                       "spawn_queue,quality,"
+                       "box_id,x,y,effect\n");
+    for (const auto& record : records)
+        writeRecord (out, header, record);
+
+    if (out != stdout)
+        std::fclose (out);
+    std::fprintf (stderr, "%zu records (%" PRIu64 " written, ring of %" PRIu64 ")\n",
+                  records.size (), header.written, header.capacity);
+    return 0;
+}